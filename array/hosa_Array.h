@@ -33,8 +33,13 @@ public:
     
     Array() = default;
     Array (Array&& other) noexcept;
+    
+    /** Copies get their memory from the heap, whatever resource the original uses. */
     Array (const Array& other);
     
+    /** An empty Array that gets its memory from the given resource, which has to outlive it. */
+    explicit Array (MemoryResource& resource) noexcept;
+    
     
     template <typename... RestElements>
     explicit Array (ContainedType&& firstElement, RestElements&&... restElements);
@@ -108,6 +113,9 @@ public:
     
     void ensureAllocatedSpace (int minNumElements);
     
+    /** The resource the elements live in, the default (heap) resource if the Array wasn't given one. */
+    [[nodiscard]] MemoryResource& getMemoryResource() const noexcept;
+    
     
 private:
     
@@ -198,6 +206,13 @@ Array<ContainedType>::Array (const Array& other)
 }
 
 
+template <typename ContainedType>
+Array<ContainedType>::Array (MemoryResource& resource) noexcept
+    : elements (&resource)
+{
+}
+
+
 template <typename ContainedType>
 template <typename... RestElements>
 Array<ContainedType>::Array (ContainedType&& firstElement, RestElements&&... restElements)
@@ -226,13 +241,23 @@ Array<ContainedType>::~Array()
 template <typename ContainedType>
 Array<ContainedType>& Array<ContainedType>::operator= (Array&& other) noexcept
 {
-    elements = std::move (other.elements);
-    numElements = other.numElements;
-    allocatedSpace = other.allocatedSpace;
+    clear();
     
-    other.numElements = 0;
-    other.allocatedSpace = 0;
+    // an Array keeps its resource, so elements of an Array with another resource are moved over one by one
+    if (elements.getMemoryResource() != other.elements.getMemoryResource())
+    {
+        ensureAllocatedSpace (other.numElements);
+        
+        for (auto i = 0; i < other.numElements; ++i)
+            addAssumingMemoryAllocated (std::move (other.elements[i]));
+        
+        other.clear();
+        return *this;
+    }
     
+    elements.swapWith (other.elements);
+    std::swap (numElements, other.numElements);
+    std::swap (allocatedSpace, other.allocatedSpace);
     return *this;
 }
 
@@ -240,10 +265,12 @@ Array<ContainedType>& Array<ContainedType>::operator= (Array&& other) noexcept
 template <typename ContainedType>
 Array<ContainedType>& Array<ContainedType>::operator= (const Array& other)
 {
-    clear();
-    addFromBuffer (other.elements, other.numElements);
-    numElements = other.numElements;
-    allocatedSpace = other.allocatedSpace;
+    if (this != &other)
+    {
+        clear();
+        addFromBuffer (other.elements, other.numElements);
+    }
+    
     return *this;
 }
 
@@ -471,6 +498,14 @@ void Array<ContainedType>::ensureAllocatedSpace (int minNumElements)
     eon_assert (allocatedSpace <= 0 || elements != nullptr, "");
 }
 
+
+template <typename ContainedType>
+MemoryResource& Array<ContainedType>::getMemoryResource() const noexcept
+{
+    auto* resource = elements.getMemoryResource();
+    return resource != nullptr ? *resource : getDefaultMemoryResource();
+}
+
 //==============================================================================
 
 template <typename ContainedType>
@@ -485,7 +520,7 @@ template <typename ContainedType>
 template <typename T>
 NonTriviallyCopyableVoid<T> Array<ContainedType>::setAllocatedSizeInternal (int newNumElements)
 {
-    details::DynamicMemoryBlock<ContainedType> newElements (newNumElements);
+    details::DynamicMemoryBlock<ContainedType> newElements (newNumElements, false, elements.getMemoryResource());
 
     for (int i = 0; i < numElements; ++i)
     {
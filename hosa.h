@@ -20,6 +20,23 @@
 
 #pragma once
 
+#include "utility/hosa_MemoryResource.h"
+#include "utility/hosa_Writer.h"
 #include "array/hosa_Array.h"
 #include "string/hosa_String.h"
+#include "string/hosa_Concatenation.h"
+#include "string/hosa_StringBuilder.h"
+#include "string/hosa_StringTokenizer.h"
+#include "string/hosa_StringView.h"
+#include "string/hosa_Rope.h"
+#include "string/hosa_SharedString.h"
+#include "string/hosa_StringPool.h"
+#include "string/hosa_FormatString.h"
+#include "string/hosa_MultiPatternMatcher.h"
+#include "string/hosa_GlobPattern.h"
+#include "map/hosa_HashMap.h"
+#include "map/hosa_HashSet.h"
+#include "io/hosa_MappedFile.h"
+#include "io/hosa_LineReader.h"
+#include "io/hosa_AsyncLogger.h"
 
@@ -0,0 +1,561 @@
+/*
+    Copyright (C)2020 Wouter Ensink
+
+    This file is part of the Hosa [Header Only String & Array] C++ Project
+        - see the github page to find out more: www.github.com/w-ensink/hosa
+
+    The code in this file is provided under the terms of the ISC license:
+    Permission to use, copy, modify, and/or distribute this software for any purpose with
+    or without fee is hereby granted, provided that the above copyright notice and this
+    permission notice appear in all copies.
+
+    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO
+    THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT
+    SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR
+    ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF
+    CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE
+    OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include "../array/hosa_Array.h"
+#include "../string/hosa_StringBuilder.h"
+#include "../string/hosa_StringView.h"
+#include "../utility/hosa_DynamicMemoryBlock.h"
+#include "../utility/hosa_Writer.h"
+
+namespace hosa
+{
+
+/** A logger that leaves the formatting and writing to a background thread, so logging only costs
+    the calling thread a copy of the arguments into a ring buffer (no locks, no allocations and no
+    system calls).
+
+    Every thread that logs gets its own single producer, single consumer ring buffer. A log call
+    stores the level, a timestamp, the pattern and the raw arguments in it. The background thread
+    formats them like String::formatted does, and writes them out in batches through a Writer:
+
+    2026-10-16 09:41:07.318275 INFO    request 1432 took 0.27 ms
+
+    The pattern isn't copied, so it has to outlive the logger (a string literal does). Text arguments
+    are copied. Lines of different threads are written in batches per thread, so they are only
+    ordered by time within each thread. When a ring buffer is full, the log call either drops
+    the line (and counts it) or waits for room, depending on the OverflowPolicy.
+
+    @code
+    auto logger = AsyncLogger();
+    logger.info ("request {} took {} ms", requestId, milliSeconds);
+    @endcode
+ */
+class AsyncLogger final
+{
+public:
+
+    enum class Level
+    {
+        debug,
+        info,
+        warning,
+        error
+    };
+
+    enum class OverflowPolicy
+    {
+        drop,
+        block
+    };
+
+    static constexpr int defaultRingBufferSize = 64 * 1024;
+
+    /** Starts the background thread. The ring buffer size is per thread, and is rounded up to a power of two. */
+    explicit AsyncLogger (int fileDescriptorToWriteTo = Writer::standardOutput,
+                          OverflowPolicy policy = OverflowPolicy::drop,
+                          int ringBufferSize = defaultRingBufferSize)
+        : overflowPolicy (policy),
+          ringSize (roundUpToPowerOfTwo (ringBufferSize < 1024 ? 1024 : ringBufferSize)),
+          writer (fileDescriptorToWriteTo)
+    {
+        backgroundThread = std::thread ([this] { run(); });
+    }
+
+    /** Writes out everything that was logged before stopping the background thread. */
+    ~AsyncLogger()
+    {
+        {
+            const std::lock_guard<std::mutex> lock (wakeUpMutex);
+            shouldStop = true;
+        }
+
+        wakeUp.notify_one();
+        backgroundThread.join();
+    }
+
+    AsyncLogger (const AsyncLogger&) = delete;
+    AsyncLogger& operator= (const AsyncLogger&) = delete;
+
+    //==============================================================================
+
+    /** Logs the pattern with each {} replaced by the next argument. Returns false if the line
+        was dropped because the ring buffer was full (or because it's bigger than the whole buffer).
+        Lines below the minimum level are skipped without a cost, and count as logged.
+     */
+    template <typename... Arguments>
+    bool log (Level level, const char* pattern, const Arguments&... arguments)
+    {
+        if ((int) level < minimumLevel.load (std::memory_order_relaxed))
+            return true;
+
+        auto payloadSize = (std::size_t) (0 + ... + encodedSize (arguments));
+        auto recordSize = (sizeof (RecordHeader) + payloadSize + 7) & ~(std::size_t) 7;
+        auto& ring = getRingForThisThread();
+        auto* record = ring.startWriting (recordSize);
+
+        while (record == nullptr && overflowPolicy == OverflowPolicy::block && ring.canEverFit (recordSize))
+        {
+            wakeUp.notify_one();
+            std::this_thread::yield();
+            record = ring.startWriting (recordSize);
+        }
+
+        if (record == nullptr)
+        {
+            numDropped.fetch_add (1, std::memory_order_relaxed);
+            return false;
+        }
+
+        auto header = RecordHeader { (std::uint32_t) recordSize, (std::uint32_t) level, now(), pattern,
+                                     &formatRecord<typename Encoding<Arguments>::DecodedType...> };
+        memcpy (record, &header, sizeof (header));
+        auto* payload = record + sizeof (header);
+        (encode (payload, arguments), ...);
+
+        if (ring.finishWriting (recordSize))
+            wakeUp.notify_one();
+
+        return true;
+    }
+
+    template <typename... Arguments>
+    bool debug (const char* pattern, const Arguments&... arguments)   { return log (Level::debug, pattern, arguments...); }
+
+    template <typename... Arguments>
+    bool info (const char* pattern, const Arguments&... arguments)    { return log (Level::info, pattern, arguments...); }
+
+    template <typename... Arguments>
+    bool warning (const char* pattern, const Arguments&... arguments) { return log (Level::warning, pattern, arguments...); }
+
+    template <typename... Arguments>
+    bool error (const char* pattern, const Arguments&... arguments)   { return log (Level::error, pattern, arguments...); }
+
+    /** Lines with a lower level than this are skipped. */
+    void setMinimumLevel (Level level) noexcept { minimumLevel.store ((int) level, std::memory_order_relaxed); }
+
+    /** Waits until everything this thread logged so far has been written out. */
+    void flush()
+    {
+        auto lock = std::unique_lock<std::mutex> (wakeUpMutex);
+        auto request = ++numFlushesRequested;
+        wakeUp.notify_one();
+        flushed.wait (lock, [&] { return numFlushesDone >= request; });
+    }
+
+    /** The number of lines that were dropped because a ring buffer was full. */
+    [[nodiscard]] std::uint64_t getNumDropped() const noexcept { return numDropped.load (std::memory_order_relaxed); }
+
+private:
+
+    using FormatFunction = void (*) (StringBuilder&, const char* pattern, const unsigned char* payload);
+
+    // every record starts with this, followed by the encoded arguments, and is padded to a multiple of 8 bytes
+    struct RecordHeader
+    {
+        std::uint32_t size;
+        std::uint32_t level;
+        std::int64_t timestamp;
+        const char* pattern;
+        FormatFunction format;
+    };
+
+    //==============================================================================
+
+    // a ring buffer of records with one writing and one reading thread, the positions only ever grow
+    class Ring final
+    {
+    public:
+
+        Ring (std::size_t size, std::thread::id ownerThread)
+            : owner (ownerThread), buffer (size), capacity (size)
+        {
+        }
+
+        bool canEverFit (std::size_t recordSize) const noexcept { return recordSize <= capacity; }
+
+        // returns where the record can be written, or nullptr if there's no room for it
+        unsigned char* startWriting (std::size_t recordSize)
+        {
+            if (! canEverFit (recordSize))
+                return nullptr;
+
+            auto position = writePosition.load (std::memory_order_relaxed);
+            auto offset = position & (capacity - 1);
+
+            // records don't wrap around, if it doesn't fit before the end the rest of the buffer is skipped.
+            // The skip is made visible on its own, and only once the reader has passed the previous one,
+            // so there's never more than one skip that the reader still has to find in skipPosition
+            if (recordSize > capacity - offset)
+            {
+                auto endOfBuffer = position + capacity - offset;
+
+                if (! isFreeUpTo (endOfBuffer, false))
+                    return nullptr;
+
+                skipPosition.store (position, std::memory_order_relaxed);
+                writePosition.store (endOfBuffer, std::memory_order_release);
+                position = endOfBuffer;
+            }
+
+            if (! isFreeUpTo (position + recordSize, true))
+                return nullptr;
+
+            return buffer.getData() + (position & (capacity - 1));
+        }
+
+        // makes the record visible to the reader, and returns true if the reader should be woken up
+        bool finishWriting (std::size_t recordSize) noexcept
+        {
+            auto position = writePosition.load (std::memory_order_relaxed) + recordSize;
+            writePosition.store (position, std::memory_order_release);
+            return position - readPosition.load (std::memory_order_relaxed) > capacity / 2;
+        }
+
+        template <typename Callback>
+        bool readAll (Callback&& handleRecord)
+        {
+            auto position = readPosition.load (std::memory_order_relaxed);
+            auto end = writePosition.load (std::memory_order_acquire);
+
+            if (position == end)
+                return false;
+
+            while (position != end)
+            {
+                if (position == skipPosition.load (std::memory_order_relaxed))
+                {
+                    position += capacity - (position & (capacity - 1));
+                }
+                else
+                {
+                    auto* record = buffer.getData() + (position & (capacity - 1));
+                    auto size = std::uint32_t();
+                    memcpy (&size, record, sizeof (size));
+
+                    handleRecord (record);
+                    position += size;
+                }
+
+                readPosition.store (position, std::memory_order_release);
+            }
+
+            return true;
+        }
+
+        const std::thread::id owner;
+
+    private:
+
+        // true if writing up to the given position won't overwrite anything the reader still needs.
+        // Skipped bytes are never read, so once the reader has got to a skip they can be written over
+        bool isFreeUpTo (std::uint64_t end, bool canWriteOverSkip) noexcept
+        {
+            auto isFree = [&]
+            {
+                auto position = cachedReadPosition;
+
+                if (canWriteOverSkip && position == skipPosition.load (std::memory_order_relaxed))
+                    position += capacity - (position & (capacity - 1));
+
+                return end - position <= capacity;
+            };
+
+            if (isFree())
+                return true;
+
+            cachedReadPosition = readPosition.load (std::memory_order_acquire);
+            return isFree();
+        }
+
+        details::DynamicMemoryBlock<unsigned char> buffer;
+        const std::size_t capacity;
+
+        // owned by the writing thread
+        std::uint64_t cachedReadPosition = 0;
+
+        // on their own cache lines, so the threads don't slow each other down
+        alignas (64) std::atomic<std::uint64_t> writePosition { 0 };
+        std::atomic<std::uint64_t> skipPosition { std::numeric_limits<std::uint64_t>::max() };
+        alignas (64) std::atomic<std::uint64_t> readPosition { 0 };
+    };
+
+    //==============================================================================
+
+    // numbers and chars are stored as they are, everything else as text: a length followed by the chars
+    template <typename Type, typename = void>
+    struct Encoding
+    {
+        using DecodedType = StringView;
+    };
+
+    template <typename Type>
+    struct Encoding<Type, std::enable_if_t<std::is_arithmetic<Type>::value>>
+    {
+        using DecodedType = Type;
+    };
+
+    template <typename Type>
+    static StringView toText (const Type& value) noexcept
+    {
+        if constexpr (std::is_convertible<const Type&, const char*>::value)
+            return StringView (static_cast<const char*> (value));
+        else if constexpr (std::is_convertible<const Type&, StringView>::value)
+            return static_cast<StringView> (value);
+        else
+            return StringView (value.data(), (int) value.length());
+    }
+
+    template <typename Type>
+    static std::size_t encodedSize (const Type& value) noexcept
+    {
+        if constexpr (std::is_arithmetic<Type>::value)
+            return sizeof (Type);
+        else
+            return sizeof (int) + (std::size_t) toText (value).length();
+    }
+
+    template <typename Type>
+    static void encode (unsigned char*& destination, const Type& value) noexcept
+    {
+        if constexpr (std::is_arithmetic<Type>::value)
+        {
+            memcpy (destination, &value, sizeof (Type));
+            destination += sizeof (Type);
+        }
+        else
+        {
+            auto text = toText (value);
+            auto length = text.length();
+            memcpy (destination, &length, sizeof (int));
+            memcpy (destination + sizeof (int), text.data(), (std::size_t) length);
+            destination += sizeof (int) + (std::size_t) length;
+        }
+    }
+
+    template <typename DecodedType>
+    static DecodedType decode (const unsigned char*& source) noexcept
+    {
+        if constexpr (std::is_arithmetic<DecodedType>::value)
+        {
+            DecodedType value;
+            memcpy (&value, source, sizeof (DecodedType));
+            source += sizeof (DecodedType);
+            return value;
+        }
+        else
+        {
+            auto length = 0;
+            memcpy (&length, source, sizeof (int));
+            auto text = StringView (reinterpret_cast<const char*> (source + sizeof (int)), length);
+            source += sizeof (int) + (std::size_t) length;
+            return text;
+        }
+    }
+
+    template <typename... DecodedTypes>
+    static void formatRecord (StringBuilder& builder, const char* pattern, const unsigned char* payload)
+    {
+        // a braced list is evaluated from left to right, so the arguments are decoded in order
+        const std::tuple<DecodedTypes...> arguments { decode<DecodedTypes> (payload)... };
+        std::apply ([&] (const auto&... values) { builder.appendFormat (pattern, values...); }, arguments);
+    }
+
+    //==============================================================================
+
+    static std::int64_t now() noexcept
+    {
+        using namespace std::chrono;
+        return duration_cast<microseconds> (system_clock::now().time_since_epoch()).count();
+    }
+
+    static std::size_t roundUpToPowerOfTwo (int size) noexcept
+    {
+        auto result = (std::size_t) 1;
+
+        while (result < (std::size_t) size)
+            result <<= 1;
+
+        return result;
+    }
+
+    Ring& getRingForThisThread()
+    {
+        // remembers the ring of the last logger this thread used, ids are never reused
+        thread_local std::uint64_t cachedLoggerId = 0;
+        thread_local Ring* cachedRing = nullptr;
+
+        if (cachedLoggerId != id)
+        {
+            cachedRing = &findOrCreateRing();
+            cachedLoggerId = id;
+        }
+
+        return *cachedRing;
+    }
+
+    Ring& findOrCreateRing()
+    {
+        const std::lock_guard<std::mutex> lock (ringsMutex);
+        auto thisThread = std::this_thread::get_id();
+
+        for (auto& ring : rings)
+            if (ring->owner == thisThread)
+                return *ring;
+
+        rings.add (std::make_unique<Ring> (ringSize, thisThread));
+        return *rings[rings.getNumItems() - 1];
+    }
+
+    //==============================================================================
+
+    void run()
+    {
+        auto ringsToRead = Array<Ring*>();
+        auto foundRecords = false;
+
+        for (;;)
+        {
+            // only sleeps when the previous round found nothing to write
+            auto lock = std::unique_lock<std::mutex> (wakeUpMutex);
+
+            if (! foundRecords)
+                wakeUp.wait_for (lock, std::chrono::milliseconds (1), [this] { return shouldStop || numFlushesRequested > numFlushesDone; });
+
+            auto stopping = shouldStop;
+            auto flushRequest = numFlushesRequested;
+            lock.unlock();
+
+            {
+                const std::lock_guard<std::mutex> ringsLock (ringsMutex);
+                ringsToRead.clear();
+
+                for (auto& ring : rings)
+                    ringsToRead.add (ring.get());
+            }
+
+            foundRecords = false;
+
+            for (auto* ring : ringsToRead)
+                foundRecords |= ring->readAll ([this] (const unsigned char* record) { writeRecord (record); });
+
+            writer.flush();
+
+            lock.lock();
+            numFlushesDone = flushRequest;
+            lock.unlock();
+            flushed.notify_all();
+
+            if (stopping)
+                return;
+        }
+    }
+
+    void writeRecord (const unsigned char* record)
+    {
+        static constexpr const char* levelNames[] { "DEBUG   ", "INFO    ", "WARNING ", "ERROR   " };
+
+        auto header = RecordHeader();
+        memcpy (&header, record, sizeof (header));
+
+        line.clear();
+        appendTimestamp (header.timestamp);
+        line.append (levelNames[header.level]);
+        header.format (line, header.pattern, record + sizeof (header));
+        line.append ('\n');
+        writer.write (line.view().data(), (std::size_t) line.length());
+    }
+
+    // the date and time only change once per second, so they're kept until then
+    void appendTimestamp (std::int64_t microSeconds)
+    {
+        auto seconds = microSeconds / 1000000;
+
+        if (seconds != lastSecond)
+        {
+            auto time = (std::time_t) seconds;
+            std::tm parts {};
+
+           #if defined (_WIN32)
+            localtime_s (&parts, &time);
+           #else
+            localtime_r (&time, &parts);
+           #endif
+
+            dateAndTimeLength = (int) std::strftime (dateAndTime, sizeof (dateAndTime), "%Y-%m-%d %H:%M:%S.", &parts);
+            lastSecond = seconds;
+        }
+
+        char fraction[8];
+        auto remainder = (int) (microSeconds - seconds * 1000000);
+
+        for (auto i = 5; i >= 0; --i, remainder /= 10)
+            fraction[i] = (char) ('0' + remainder % 10);
+
+        fraction[6] = ' ';
+        line.append (StringView (dateAndTime, dateAndTimeLength));
+        line.append (StringView (fraction, 7));
+    }
+
+    //==============================================================================
+
+    static std::uint64_t createId() noexcept
+    {
+        static std::atomic<std::uint64_t> lastId { 0 };
+        return ++lastId;
+    }
+
+    const std::uint64_t id = createId();
+    const OverflowPolicy overflowPolicy;
+    const std::size_t ringSize;
+    std::atomic<int> minimumLevel { (int) Level::debug };
+    std::atomic<std::uint64_t> numDropped { 0 };
+
+    std::mutex ringsMutex;
+    Array<std::unique_ptr<Ring>> rings;
+
+    std::mutex wakeUpMutex;
+    std::condition_variable wakeUp, flushed;
+    bool shouldStop = false;
+    std::uint64_t numFlushesRequested = 0, numFlushesDone = 0;
+
+    // only used by the background thread
+    Writer writer;
+    StringBuilder line { 256 };
+    std::int64_t lastSecond = -1;
+    char dateAndTime[32] {};
+    int dateAndTimeLength = 0;
+    std::thread backgroundThread;
+};
+
+} // namespace hosa
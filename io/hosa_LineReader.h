@@ -0,0 +1,226 @@
+/*
+    Copyright (C)2020 Wouter Ensink
+
+    This file is part of the Hosa [Header Only String & Array] C++ Project
+        - see the github page to find out more: www.github.com/w-ensink/hosa
+
+    The code in this file is provided under the terms of the ISC license:
+    Permission to use, copy, modify, and/or distribute this software for any purpose with
+    or without fee is hereby granted, provided that the above copyright notice and this
+    permission notice appear in all copies.
+
+    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO
+    THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT
+    SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR
+    ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF
+    CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE
+    OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+
+#pragma once
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include "../string/hosa_StringSearch.h"
+#include "../string/hosa_StringView.h"
+#include "../utility/hosa_DynamicMemoryBlock.h"
+
+#if defined (_WIN32)
+    #include <fcntl.h>
+    #include <io.h>
+#else
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+namespace hosa
+{
+
+/** Reads text from a file descriptor line by line, without copying the lines and without
+    reading the whole file into memory.
+
+    The data is read in blocks into a single buffer, and every line is handed out as a StringView
+    into that buffer, which stays valid until the next call to readNextLine(). The line ending
+    (\n or \r\n) isn't part of the line. The buffer only grows when a single line doesn't fit in it,
+    so the memory that's used depends on the longest line and not on the size of the file.
+
+    @code
+    auto reader = LineReader ("access.log");
+    auto line = StringView();
+
+    while (reader.readNextLine (line))
+        handle (line);
+    @endcode
+ */
+class LineReader final
+{
+public:
+
+    static constexpr int defaultBufferSize = 64 * 1024;
+
+    /** Reads from a file descriptor that was opened elsewhere, and that will not be closed by the reader. */
+    explicit LineReader (int fileDescriptorToRead, int bufferSize = defaultBufferSize)
+        : fileDescriptor (fileDescriptorToRead),
+          buffer ((std::size_t) (bufferSize < 16 ? 16 : bufferSize)),
+          capacity (bufferSize < 16 ? 16 : bufferSize)
+    {
+        // a descriptor that couldn't be opened reads as an empty file with an error
+        readError = hitEnd = fileDescriptor < 0;
+    }
+
+    /** Opens the file at the given path, which is closed again when the reader is destroyed. */
+    explicit LineReader (const char* path, int bufferSize = defaultBufferSize)
+        : LineReader (openFile (path), bufferSize)
+    {
+        ownsFileDescriptor = fileDescriptor >= 0;
+    }
+
+    LineReader (const LineReader&) = delete;
+    LineReader& operator= (const LineReader&) = delete;
+
+    ~LineReader()
+    {
+        if (ownsFileDescriptor)
+            closeFile (fileDescriptor);
+    }
+
+    //==============================================================================
+
+    /** Points the given view to the next line and returns true, or returns false if there are no
+        more lines. A last line without a line ending is still returned, an empty last line isn't.
+     */
+    bool readNextLine (StringView& line)
+    {
+        for (;;)
+        {
+            auto index = details::StringSearch::findChar (buffer.getData() + lineStart + numScanned,
+                                                          dataEnd - lineStart - numScanned, '\n');
+
+            if (index >= 0)
+            {
+                auto lineLength = numScanned + index;
+                line = makeLine (lineLength);
+                lineStart += lineLength + 1;
+                numScanned = 0;
+                return true;
+            }
+
+            numScanned = dataEnd - lineStart;
+
+            if (hitEnd)
+            {
+                if (lineStart == dataEnd)
+                    return false;
+
+                line = makeLine (dataEnd - lineStart);
+                lineStart = dataEnd;
+                numScanned = 0;
+                return true;
+            }
+
+            refill();
+        }
+    }
+
+    /** The number of lines that were returned so far. */
+    [[nodiscard]] std::int64_t getNumLinesRead() const noexcept { return numLinesRead; }
+
+    /** True if the file couldn't be opened, or if reading stopped because of an error instead of at the end. */
+    [[nodiscard]] bool hadReadError() const noexcept { return readError; }
+
+    /** The current size of the buffer, which only grows for lines that are longer than it. */
+    [[nodiscard]] int getBufferSize() const noexcept { return capacity; }
+
+private:
+
+    static int openFile (const char* path) noexcept
+    {
+       #if defined (_WIN32)
+        return ::_open (path, _O_RDONLY | _O_BINARY);
+       #else
+        return ::open (path, O_RDONLY | O_CLOEXEC);
+       #endif
+    }
+
+    static void closeFile (int fd) noexcept
+    {
+       #if defined (_WIN32)
+        ::_close (fd);
+       #else
+        ::close (fd);
+       #endif
+    }
+
+    StringView makeLine (int length) noexcept
+    {
+        auto* chars = buffer.getData() + lineStart;
+
+        if (length > 0 && chars[length - 1] == '\r')
+            --length;
+
+        ++numLinesRead;
+        return { chars, length };
+    }
+
+    // moves the unfinished line to the front of the buffer (growing it if the line fills all of it),
+    // and reads as much as fits behind it
+    void refill()
+    {
+        auto numLeft = dataEnd - lineStart;
+
+        if (lineStart > 0)
+        {
+            memmove (buffer.getData(), buffer.getData() + lineStart, (std::size_t) numLeft);
+            lineStart = 0;
+            dataEnd = numLeft;
+        }
+
+        if (dataEnd == capacity)
+        {
+            capacity = static_cast<int> (((uint32_t) (capacity + capacity / 2 + 8)) & ~7u);
+            buffer.reallocate ((std::size_t) capacity);
+        }
+
+        for (;;)
+        {
+           #if defined (_WIN32)
+            auto numRead = (long long) ::_read (fileDescriptor, buffer.getData() + dataEnd, (unsigned int) (capacity - dataEnd));
+           #else
+            auto numRead = (long long) ::read (fileDescriptor, buffer.getData() + dataEnd, (std::size_t) (capacity - dataEnd));
+           #endif
+
+            if (numRead > 0)
+            {
+                dataEnd += (int) numRead;
+                return;
+            }
+
+            if (numRead < 0 && errno == EINTR)
+                continue;
+
+            readError = numRead < 0;
+            hitEnd = true;
+            return;
+        }
+    }
+
+
+    int fileDescriptor;
+    bool ownsFileDescriptor = false;
+    details::DynamicMemoryBlock<char> buffer;
+    int capacity;
+
+    // the unfinished line is [lineStart, dataEnd), of which the first numScanned chars hold no '\n'
+    int lineStart = 0;
+    int dataEnd = 0;
+    int numScanned = 0;
+
+    bool hitEnd = false;
+    bool readError = false;
+    std::int64_t numLinesRead = 0;
+};
+
+} // namespace hosa
@@ -0,0 +1,241 @@
+/*
+    Copyright (C)2020 Wouter Ensink
+
+    This file is part of the Hosa [Header Only String & Array] C++ Project
+        - see the github page to find out more: www.github.com/w-ensink/hosa
+
+    The code in this file is provided under the terms of the ISC license:
+    Permission to use, copy, modify, and/or distribute this software for any purpose with
+    or without fee is hereby granted, provided that the above copyright notice and this
+    permission notice appear in all copies.
+
+    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO
+    THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT
+    SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR
+    ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF
+    CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE
+    OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+#include <utility>
+#include "../string/hosa_StringView.h"
+
+#if defined (__unix__) || defined (__APPLE__)
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+    #define HOSA_MAPPED_FILES 1
+#else
+    #define HOSA_MAPPED_FILES 0
+#endif
+
+namespace hosa
+{
+
+/** Gives read access to the contents of a file by mapping it into memory, so nothing has to be
+    copied: pages are read in by the operating system when they're first touched, and can be
+    dropped again under memory pressure. Sizes and offsets are 64 bit, so it works for files of
+    any size, but the StringViews it hands out are windows of at most 2 GB.
+
+    On platforms without mmap the file is read into memory as a whole instead.
+
+    @code
+    auto file = MappedFile ("events.log", MappedFile::AccessPattern::sequential);
+
+    for (auto offset = (std::int64_t) 0; offset < file.getSize(); offset += windowSize)
+        process (file.view (offset, windowSize));
+    @endcode
+ */
+class MappedFile final
+{
+public:
+
+    /** Tells the operating system how the file is going to be read, so it can read ahead or not. */
+    enum class AccessPattern
+    {
+        normal,
+        sequential,
+        random
+    };
+
+    MappedFile() noexcept = default;
+
+    explicit MappedFile (const char* path, AccessPattern accessPattern = AccessPattern::normal)
+    {
+       #if HOSA_MAPPED_FILES
+        auto fileDescriptor = ::open (path, O_RDONLY | O_CLOEXEC);
+
+        if (fileDescriptor < 0)
+            return;
+
+        struct stat info;
+
+        if (::fstat (fileDescriptor, &info) == 0)
+        {
+            if (info.st_size > 0)
+            {
+                auto* mapping = ::mmap (nullptr, (std::size_t) info.st_size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+
+                if (mapping != MAP_FAILED)
+                {
+                    start = static_cast<const char*> (mapping);
+                    numBytes = (std::int64_t) info.st_size;
+                }
+            }
+
+            opened = start != nullptr || info.st_size == 0;
+        }
+
+        // the mapping keeps the file alive by itself
+        ::close (fileDescriptor);
+        advise (accessPattern);
+       #else
+        (void) accessPattern;
+        readWholeFile (path);
+       #endif
+    }
+
+    MappedFile (MappedFile&& other) noexcept
+        : start (std::exchange (other.start, nullptr)),
+          numBytes (std::exchange (other.numBytes, 0)),
+          opened (std::exchange (other.opened, false))
+    {
+    }
+
+    MappedFile& operator= (MappedFile&& other) noexcept
+    {
+        std::swap (start, other.start);
+        std::swap (numBytes, other.numBytes);
+        std::swap (opened, other.opened);
+        return *this;
+    }
+
+    MappedFile (const MappedFile&) = delete;
+    MappedFile& operator= (const MappedFile&) = delete;
+
+    ~MappedFile() { close(); }
+
+    //==============================================================================
+
+    /** False if the file couldn't be opened or mapped. An empty file counts as opened. */
+    [[nodiscard]] bool isOpen() const noexcept { return opened; }
+
+    [[nodiscard]] const char* data() const noexcept     { return start; }
+    [[nodiscard]] std::int64_t getSize() const noexcept { return numBytes; }
+    [[nodiscard]] bool isEmpty() const noexcept         { return numBytes == 0; }
+
+    /** The whole file, for files smaller than 2 GB. Bigger files are cut off, use view (offset, length) for those. */
+    [[nodiscard]] StringView view() const noexcept { return view (0, std::numeric_limits<int>::max()); }
+
+    /** A window of (at most) the given length into the file, starting at the given offset.
+        The window is cut off at the end of the file.
+     */
+    [[nodiscard]] StringView view (std::int64_t offset, int length) const noexcept
+    {
+        if (offset < 0 || offset >= numBytes || length <= 0)
+            return {};
+
+        auto available = numBytes - offset;
+        return { start + offset, available < length ? (int) available : length };
+    }
+
+    /** Changes the read ahead behaviour for the whole file. */
+    void advise (AccessPattern accessPattern) const noexcept
+    {
+       #if HOSA_MAPPED_FILES
+        if (start != nullptr)
+            ::madvise (const_cast<char*> (start), (std::size_t) numBytes, toAdvice (accessPattern));
+       #else
+        (void) accessPattern;
+       #endif
+    }
+
+    /** Asks the operating system to start reading the given range in the background,
+        because it will be needed soon.
+     */
+    void prefetch (std::int64_t offset, std::int64_t length) const noexcept
+    {
+       #if HOSA_MAPPED_FILES
+        if (offset < 0 || offset >= numBytes || length <= 0)
+            return;
+
+        // madvise wants a page aligned start
+        auto pageSize = (std::int64_t) ::sysconf (_SC_PAGESIZE);
+        auto alignedOffset = offset - offset % pageSize;
+        auto end = offset + length < numBytes ? offset + length : numBytes;
+        ::madvise (const_cast<char*> (start) + alignedOffset, (std::size_t) (end - alignedOffset), MADV_WILLNEED);
+       #else
+        (void) offset;
+        (void) length;
+       #endif
+    }
+
+    /** Unmaps the file, after which all views into it are invalid. */
+    void close() noexcept
+    {
+        if (start != nullptr)
+        {
+           #if HOSA_MAPPED_FILES
+            ::munmap (const_cast<char*> (start), (std::size_t) numBytes);
+           #else
+            delete[] start;
+           #endif
+        }
+
+        start = nullptr;
+        numBytes = 0;
+        opened = false;
+    }
+
+private:
+
+   #if HOSA_MAPPED_FILES
+    static int toAdvice (AccessPattern accessPattern) noexcept
+    {
+        switch (accessPattern)
+        {
+            case AccessPattern::sequential: return MADV_SEQUENTIAL;
+            case AccessPattern::random:     return MADV_RANDOM;
+            default:                        return MADV_NORMAL;
+        }
+    }
+   #else
+    void readWholeFile (const char* path)
+    {
+        auto* file = std::fopen (path, "rb");
+
+        if (file == nullptr)
+            return;
+
+        if (std::fseek (file, 0, SEEK_END) == 0)
+        {
+            auto size = (std::int64_t) std::ftell (file);
+
+            if (size > 0 && std::fseek (file, 0, SEEK_SET) == 0)
+            {
+                auto* buffer = new char[(std::size_t) size];
+                numBytes = (std::int64_t) std::fread (buffer, 1, (std::size_t) size, file);
+                start = buffer;
+            }
+
+            opened = size >= 0;
+        }
+
+        std::fclose (file);
+    }
+   #endif
+
+
+    const char* start = nullptr;
+    std::int64_t numBytes = 0;
+    bool opened = false;
+};
+
+} // namespace hosa
@@ -0,0 +1,120 @@
+/*
+    Copyright (C)2020 Wouter Ensink
+
+    This file is part of the Hosa [Header Only String & Array] C++ Project
+        - see the github page to find out more: www.github.com/w-ensink/hosa
+
+    The code in this file is provided under the terms of the ISC license:
+    Permission to use, copy, modify, and/or distribute this software for any purpose with
+    or without fee is hereby granted, provided that the above copyright notice and this
+    permission notice appear in all copies.
+
+    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO
+    THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT
+    SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR
+    ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF
+    CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE
+    OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+
+#pragma once
+
+#include "hosa_HashTable.h"
+
+namespace hosa
+{
+
+/** An unordered map from keys to values, for symbol tables, caches and the like.
+
+    It's an open addressing table that checks 16 slots at a time, by comparing 7 bits of the hash
+    of each key with SSE2 instructions, so lookups rarely touch more than one cache line of keys.
+    Maps with a string type as key can be searched with any other string type (a StringView,
+    a C string...), without making a String for the lookup.
+
+    @code
+    auto symbols = HashMap<String, int>();
+    symbols["main"] = 0x400000;
+
+    if (auto* address = symbols.find (name.substringView (0, 4)))
+        ...
+    @endcode
+
+    Adding or removing items invalidates pointers to values and iterators.
+ */
+template <typename Key, typename Value>
+class HashMap final
+{
+public:
+
+    using Entry = details::HashMapEntry<Key, Value>;
+
+    HashMap() = default;
+
+    [[nodiscard]] int getNumItems() const noexcept { return table.getNumItems(); }
+    [[nodiscard]] bool isEmpty() const noexcept    { return table.getNumItems() == 0; }
+
+    /** Makes sure the given number of items fit without rehashing. */
+    void reserve (int minNumItems) { table.reserve (minNumItems); }
+
+    void clear() noexcept { table.clear(); }
+
+    //==============================================================================
+
+    /** Returns the value for the given key, or nullptr if the key isn't in the map. */
+    template <typename LookupKey, typename = details::HashLookupType<Key, LookupKey>>
+    [[nodiscard]] Value* find (const LookupKey& key) noexcept
+    {
+        auto* entry = table.find (key);
+        return entry == nullptr ? nullptr : &entry->value;
+    }
+
+    template <typename LookupKey, typename = details::HashLookupType<Key, LookupKey>>
+    [[nodiscard]] const Value* find (const LookupKey& key) const noexcept
+    {
+        auto* entry = table.find (key);
+        return entry == nullptr ? nullptr : &entry->value;
+    }
+
+    template <typename LookupKey, typename = details::HashLookupType<Key, LookupKey>>
+    [[nodiscard]] bool contains (const LookupKey& key) const noexcept { return table.find (key) != nullptr; }
+
+    /** Returns the value for the given key, after adding a default constructed one if the key wasn't in the map. */
+    template <typename LookupKey, typename = details::HashInsertType<Key, LookupKey>>
+    Value& operator[] (const LookupKey& key)
+    {
+        return table.findOrInsert (key, [&key] (void* place) { new (place) Entry { Key (key), Value() }; }).first->value;
+    }
+
+    /** Sets the value for the given key, and returns true if the key is new to the map. */
+    template <typename LookupKey, typename = details::HashInsertType<Key, LookupKey>>
+    bool set (const LookupKey& key, Value value)
+    {
+        auto result = table.findOrInsert (key, [&] (void* place) { new (place) Entry { Key (key), std::move (value) }; });
+
+        if (! result.second)
+            result.first->value = std::move (value);
+
+        return result.second;
+    }
+
+    /** Removes the given key and its value, and returns whether it was in the map. */
+    template <typename LookupKey, typename = details::HashLookupType<Key, LookupKey>>
+    bool remove (const LookupKey& key) noexcept { return table.erase (key); }
+
+    //==============================================================================
+
+    /** Iterates over the entries (with a key and a value) in no particular order. The keys mustn't be changed. */
+    auto begin() noexcept       { return table.begin(); }
+    auto end() noexcept         { return table.end();   }
+    auto begin() const noexcept { return table.begin(); }
+    auto end() const noexcept   { return table.end();   }
+
+private:
+
+    using Table = details::HashTable<Key, Entry>;
+
+    Table table;
+};
+
+} // namespace hosa
@@ -0,0 +1,83 @@
+/*
+    Copyright (C)2020 Wouter Ensink
+
+    This file is part of the Hosa [Header Only String & Array] C++ Project
+        - see the github page to find out more: www.github.com/w-ensink/hosa
+
+    The code in this file is provided under the terms of the ISC license:
+    Permission to use, copy, modify, and/or distribute this software for any purpose with
+    or without fee is hereby granted, provided that the above copyright notice and this
+    permission notice appear in all copies.
+
+    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO
+    THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT
+    SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR
+    ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF
+    CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE
+    OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+
+#pragma once
+
+#include "hosa_HashTable.h"
+
+namespace hosa
+{
+
+/** An unordered set of unique keys, for deduplicating for example. Works like HashMap,
+    and also lets sets of strings be searched with any other string type.
+
+    @code
+    auto seen = HashSet<String>();
+
+    for (auto line : tokenize (text, "\n"))
+        if (seen.add (line))
+            output.add (String (line));
+    @endcode
+ */
+template <typename Key>
+class HashSet final
+{
+public:
+
+    HashSet() = default;
+
+    [[nodiscard]] int getNumItems() const noexcept { return table.getNumItems(); }
+    [[nodiscard]] bool isEmpty() const noexcept    { return table.getNumItems() == 0; }
+
+    /** Makes sure the given number of items fit without rehashing. */
+    void reserve (int minNumItems) { table.reserve (minNumItems); }
+
+    void clear() noexcept { table.clear(); }
+
+    //==============================================================================
+
+    template <typename LookupKey, typename = details::HashLookupType<Key, LookupKey>>
+    [[nodiscard]] bool contains (const LookupKey& key) const noexcept { return table.find (key) != nullptr; }
+
+    /** Adds the given key, and returns true if it wasn't in the set yet. */
+    template <typename LookupKey, typename = details::HashInsertType<Key, LookupKey>>
+    bool add (const LookupKey& key)
+    {
+        return table.findOrInsert (key, [&key] (void* place) { new (place) Key (key); }).second;
+    }
+
+    /** Removes the given key, and returns whether it was in the set. */
+    template <typename LookupKey, typename = details::HashLookupType<Key, LookupKey>>
+    bool remove (const LookupKey& key) noexcept { return table.erase (key); }
+
+    //==============================================================================
+
+    /** Iterates over the keys in no particular order. */
+    auto begin() const noexcept { return table.begin(); }
+    auto end() const noexcept   { return table.end();   }
+
+private:
+
+    using Table = details::HashTable<Key, Key>;
+
+    Table table;
+};
+
+} // namespace hosa
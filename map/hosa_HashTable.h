@@ -0,0 +1,457 @@
+/*
+    Copyright (C)2020 Wouter Ensink
+
+    This file is part of the Hosa [Header Only String & Array] C++ Project
+        - see the github page to find out more: www.github.com/w-ensink/hosa
+
+    The code in this file is provided under the terms of the ISC license:
+    Permission to use, copy, modify, and/or distribute this software for any purpose with
+    or without fee is hereby granted, provided that the above copyright notice and this
+    permission notice appear in all copies.
+
+    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO
+    THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT
+    SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR
+    ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF
+    CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE
+    OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include "../utility/hosa_CpuFeatures.h"
+#include "../utility/hosa_DynamicMemoryBlock.h"
+#include "../utility/hosa_Hashing.h"
+#include "../string/hosa_SharedString.h"
+#include "../string/hosa_StringPool.h"
+
+namespace hosa::details
+{
+
+/** How keys are hashed and compared by HashMap and HashSet, and which other types they can be looked up with.
+    By default keys are hashed with std::hash (with its bits mixed, as that's often the identity for
+    integers), compared with ==, and looked up with anything that converts to the key type.
+ */
+template <typename Key, typename = void>
+struct HashKeyTraits
+{
+    template <typename LookupKey>
+    static constexpr bool canLookUp = std::is_convertible_v<const LookupKey&, Key>;
+
+    static std::uint64_t hash (const Key& key) noexcept
+    {
+        return Hashing::mixBits (static_cast<std::uint64_t> (std::hash<Key>() (key)));
+    }
+
+    static bool equals (const Key& key, const Key& other) noexcept { return key == other; }
+};
+
+
+template <typename Key>
+constexpr bool isStringKey = std::is_same_v<Key, String> || std::is_same_v<Key, StringView>
+                              || std::is_same_v<Key, SharedString> || std::is_same_v<Key, InternedString>;
+
+/** All string types hash to the same value for the same text, so a map with String keys can be
+    searched with a StringView or a C string, without making a String for it.
+ */
+template <typename Key>
+struct HashKeyTraits<Key, std::enable_if_t<isStringKey<Key>>>
+{
+    template <typename LookupKey>
+    static constexpr bool canLookUp = std::is_convertible_v<const LookupKey&, StringView>;
+
+    static std::uint64_t hash (StringView text) noexcept                  { return text.hash(); }
+    static std::uint64_t hash (const SharedString& text) noexcept         { return text.hash(); }
+    static std::uint64_t hash (InternedString text) noexcept              { return text.hash(); }
+
+    static bool equals (const Key& key, StringView text) noexcept         { return StringView (key) == text; }
+};
+
+// the lookup functions of HashMap and HashSet take any type the key traits allow,
+// and the ones that add items also need to be able to make a key out of it
+template <typename Key, typename LookupKey>
+using HashLookupType = std::enable_if_t<HashKeyTraits<Key>::template canLookUp<LookupKey>>;
+
+template <typename Key, typename LookupKey>
+using HashInsertType = std::enable_if_t<HashKeyTraits<Key>::template canLookUp<LookupKey>
+                                         && std::is_constructible_v<Key, const LookupKey&>>;
+
+//==============================================================================
+
+/** The control bytes of 16 neighbouring slots, which are all compared at once (with SSE2 when available).
+    Every slot has a control byte which tells whether it's empty, deleted, or full. For full slots
+    it holds 7 bits of the hash of their key, so most slots that don't hold the key are skipped
+    without looking at the key at all.
+ */
+class HashTableGroup final
+{
+public:
+
+    static constexpr int width = 16;
+    static constexpr std::int8_t empty = -128;
+    static constexpr std::int8_t deleted = -2;
+
+    explicit HashTableGroup (const std::int8_t* controlBytes) noexcept
+    {
+       #if HOSA_SSE2
+        bytes = _mm_loadu_si128 (reinterpret_cast<const __m128i*> (controlBytes));
+       #else
+        memcpy (bytes, controlBytes, width);
+       #endif
+    }
+
+    /** A bit mask of the slots that are full with a key of which the hash has these 7 bits. */
+    [[nodiscard]] unsigned int match (std::int8_t hashBits) const noexcept
+    {
+       #if HOSA_SSE2
+        return (unsigned int) _mm_movemask_epi8 (_mm_cmpeq_epi8 (_mm_set1_epi8 (hashBits), bytes));
+       #else
+        return maskOf ([hashBits] (std::int8_t byte) { return byte == hashBits; });
+       #endif
+    }
+
+    [[nodiscard]] unsigned int matchEmpty() const noexcept
+    {
+       #if HOSA_SSE2
+        return (unsigned int) _mm_movemask_epi8 (_mm_cmpeq_epi8 (_mm_set1_epi8 (empty), bytes));
+       #else
+        return maskOf ([] (std::int8_t byte) { return byte == empty; });
+       #endif
+    }
+
+    // empty and deleted are the only negative control bytes
+    [[nodiscard]] unsigned int matchEmptyOrDeleted() const noexcept
+    {
+       #if HOSA_SSE2
+        return (unsigned int) _mm_movemask_epi8 (_mm_cmpgt_epi8 (_mm_set1_epi8 (-1), bytes));
+       #else
+        return maskOf ([] (std::int8_t byte) { return byte < -1; });
+       #endif
+    }
+
+private:
+
+   #if HOSA_SSE2
+    __m128i bytes;
+   #else
+    template <typename Predicate>
+    unsigned int maskOf (Predicate&& predicate) const noexcept
+    {
+        auto mask = 0u;
+
+        for (auto i = 0; i < width; ++i)
+            if (predicate (bytes[i]))
+                mask |= 1u << i;
+
+        return mask;
+    }
+
+    std::int8_t bytes[width];
+   #endif
+};
+
+//==============================================================================
+
+template <typename Key, typename Value>
+struct HashMapEntry
+{
+    Key key;
+    Value value;
+};
+
+template <typename Key>
+const Key& keyOf (const Key& key) noexcept { return key; }
+
+template <typename Key, typename Value>
+const Key& keyOf (const HashMapEntry<Key, Value>& entry) noexcept { return entry.key; }
+
+
+/** The open addressing table (in the style of Abseil's SwissTable) that HashMap and HashSet are built on.
+    Slots are either keys (for a set) or HashMapEntries (for a map).
+ */
+template <typename Key, typename Slot>
+class HashTable final
+{
+public:
+
+    using KeyTraits = HashKeyTraits<Key>;
+    using Group = HashTableGroup;
+
+    HashTable() = default;
+
+    HashTable (const HashTable& other)
+    {
+        if (other.numItems == 0)
+            return;
+
+        reserve (other.numItems);
+
+        for (auto& slot : other)
+        {
+            auto hash = KeyTraits::hash (keyOf (slot));
+            auto index = findInsertPosition (hash);
+            setControl (index, hashBitsOf (hash));
+            new (slots + index) Slot (slot);
+        }
+
+        numItems = other.numItems;
+        growthLeft -= numItems;
+    }
+
+    HashTable (HashTable&& other) noexcept
+    {
+        swapWith (other);
+    }
+
+    HashTable& operator= (const HashTable& other)
+    {
+        auto copy = other;
+        swapWith (copy);
+        return *this;
+    }
+
+    HashTable& operator= (HashTable&& other) noexcept
+    {
+        swapWith (other);
+        return *this;
+    }
+
+    ~HashTable() { destroyAll(); }
+
+    //==============================================================================
+
+    [[nodiscard]] int getNumItems() const noexcept { return numItems; }
+
+    template <typename LookupKey>
+    [[nodiscard]] Slot* find (const LookupKey& key) const noexcept
+    {
+        if (capacity == 0)
+            return nullptr;
+
+        auto hash = KeyTraits::hash (key);
+        auto hashBits = hashBitsOf (hash);
+        auto mask = capacity - 1;
+        auto position = (std::size_t) (hash >> 7) & mask;
+
+        for (auto step = (std::size_t) Group::width;; position = (position + step) & mask, step += Group::width)
+        {
+            auto group = Group (control + position);
+
+            for (auto matches = group.match (hashBits); matches != 0; matches &= matches - 1)
+            {
+                auto index = (position + (std::size_t) CpuFeatures::countTrailingZeros (matches)) & mask;
+
+                if (KeyTraits::equals (keyOf (slots[index]), key))
+                    return slots + index;
+            }
+
+            if (group.matchEmpty() != 0)
+                return nullptr;
+        }
+    }
+
+    /** Returns the slot with the given key, and whether it's new. New slots are constructed by
+        calling the given function with the memory they should be placed in.
+     */
+    template <typename LookupKey, typename ConstructSlot>
+    std::pair<Slot*, bool> findOrInsert (const LookupKey& key, ConstructSlot&& constructSlot)
+    {
+        if (auto* existing = find (key))
+            return { existing, false };
+
+        if (capacity == 0)
+            reserve (1);
+
+        auto hash = KeyTraits::hash (key);
+        auto index = findInsertPosition (hash);
+
+        // tombstones can be reused, but empty slots can only be taken while there's growth left
+        if (growthLeft == 0 && control[index] != Group::deleted)
+        {
+            rehash (numItems * 2 < maxLoad (capacity) ? capacity : capacity * 2);
+            index = findInsertPosition (hash);
+        }
+
+        if (control[index] == Group::empty)
+            --growthLeft;
+
+        setControl (index, hashBitsOf (hash));
+        constructSlot (static_cast<void*> (slots + index));
+        ++numItems;
+        return { slots + index, true };
+    }
+
+    template <typename LookupKey>
+    bool erase (const LookupKey& key) noexcept
+    {
+        auto* slot = find (key);
+
+        if (slot == nullptr)
+            return false;
+
+        slot->~Slot();
+        setControl ((std::size_t) (slot - slots), Group::deleted);
+        --numItems;
+        return true;
+    }
+
+    void clear() noexcept
+    {
+        destroyAll();
+        capacity = 0;
+        numItems = 0;
+        growthLeft = 0;
+    }
+
+    /** Makes sure the given number of items fit without rehashing. */
+    void reserve (int minNumItems)
+    {
+        auto newCapacity = capacity < Group::width ? (std::size_t) Group::width : capacity;
+
+        while (maxLoad (newCapacity) < minNumItems)
+            newCapacity *= 2;
+
+        if (newCapacity != capacity)
+            rehash (newCapacity);
+    }
+
+    //==============================================================================
+
+    template <typename SlotType>
+    class Iterator final
+    {
+    public:
+
+        using iterator_category = std::forward_iterator_tag;
+        using value_type        = std::remove_const_t<SlotType>;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = SlotType*;
+        using reference         = SlotType&;
+
+        reference operator*()  const noexcept { return table->slots[index];  }
+        pointer   operator->() const noexcept { return table->slots + index; }
+
+        Iterator& operator++() noexcept
+        {
+            ++index;
+            skipToFullSlot();
+            return *this;
+        }
+
+        bool operator== (const Iterator& other) const noexcept { return index == other.index; }
+        bool operator!= (const Iterator& other) const noexcept { return index != other.index; }
+
+    private:
+
+        friend class HashTable;
+
+        Iterator (const HashTable& owner, std::size_t startIndex) noexcept
+            : table (&owner), index (startIndex)
+        {
+            skipToFullSlot();
+        }
+
+        void skipToFullSlot() noexcept
+        {
+            while (index < table->capacity && table->control[index] < 0)
+                ++index;
+        }
+
+        const HashTable* table;
+        std::size_t index;
+    };
+
+    Iterator<Slot>       begin() noexcept        { return { *this, 0 };        }
+    Iterator<Slot>       end() noexcept          { return { *this, capacity }; }
+    Iterator<const Slot> begin() const noexcept  { return { *this, 0 };        }
+    Iterator<const Slot> end() const noexcept    { return { *this, capacity }; }
+
+private:
+
+    // the table is rehashed when it would become more than 7/8 full, counting tombstones
+    static int maxLoad (std::size_t numSlots) noexcept { return (int) (numSlots - numSlots / 8); }
+
+    static std::int8_t hashBitsOf (std::uint64_t hash) noexcept { return (std::int8_t) (hash & 0x7f); }
+
+    // the first group of control bytes is repeated after the last one, so groups can be read
+    // at any position without wrapping around
+    void setControl (std::size_t index, std::int8_t value) noexcept
+    {
+        control[index] = value;
+
+        if (index < (std::size_t) Group::width)
+            control[capacity + index] = value;
+    }
+
+    std::size_t findInsertPosition (std::uint64_t hash) const noexcept
+    {
+        auto mask = capacity - 1;
+        auto position = (std::size_t) (hash >> 7) & mask;
+
+        for (auto step = (std::size_t) Group::width;; position = (position + step) & mask, step += Group::width)
+            if (auto available = Group (control + position).matchEmptyOrDeleted())
+                return (position + (std::size_t) CpuFeatures::countTrailingZeros (available)) & mask;
+    }
+
+    void rehash (std::size_t newCapacity)
+    {
+        auto oldControl = std::move (control);
+        auto oldSlots = std::move (slots);
+        auto oldCapacity = capacity;
+
+        control.allocate (newCapacity + Group::width);
+        memset (control.getData(), Group::empty, newCapacity + Group::width);
+        slots.allocate (newCapacity);
+        capacity = newCapacity;
+
+        for (auto i = (std::size_t) 0; i < oldCapacity; ++i)
+        {
+            if (oldControl[i] < 0)
+                continue;
+
+            auto hash = KeyTraits::hash (keyOf (oldSlots[i]));
+            auto index = findInsertPosition (hash);
+            setControl (index, hashBitsOf (hash));
+            new (slots + index) Slot (std::move (oldSlots[i]));
+            oldSlots[i].~Slot();
+        }
+
+        growthLeft = maxLoad (capacity) - numItems;
+    }
+
+    void destroyAll() noexcept
+    {
+        if constexpr (! std::is_trivially_destructible_v<Slot>)
+            for (auto i = (std::size_t) 0; i < capacity; ++i)
+                if (control[i] >= 0)
+                    slots[i].~Slot();
+
+        control.free();
+        slots.free();
+    }
+
+    void swapWith (HashTable& other) noexcept
+    {
+        control.swapWith (other.control);
+        slots.swapWith (other.slots);
+        std::swap (capacity, other.capacity);
+        std::swap (numItems, other.numItems);
+        std::swap (growthLeft, other.growthLeft);
+    }
+
+
+    DynamicMemoryBlock<std::int8_t> control;
+    DynamicMemoryBlock<Slot> slots;
+    std::size_t capacity = 0;
+    int numItems = 0;
+    int growthLeft = 0;
+};
+
+} // namespace hosa::details
@@ -0,0 +1,345 @@
+/*
+    Copyright (C)2020 Wouter Ensink
+
+    This file is part of the Hosa [Header Only String & Array] C++ Project
+        - see the github page to find out more: www.github.com/w-ensink/hosa
+
+    The code in this file is provided under the terms of the ISC license:
+    Permission to use, copy, modify, and/or distribute this software for any purpose with
+    or without fee is hereby granted, provided that the above copyright notice and this
+    permission notice appear in all copies.
+
+    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO
+    THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT
+    SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR
+    ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF
+    CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE
+    OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+
+#pragma once
+
+#include "../utility/hosa_CpuFeatures.h"
+
+namespace hosa::details
+{
+
+/** ASCII case kernels, used for converting case and for all case insensitive comparing and searching.
+
+    The vectorised versions convert 16 (SSE2) or 32 (AVX2) chars per step, or fold them to
+    lower case and compare them in one go, the remaining chars are handled one by one. Only 'A' to 'Z' and
+    'a' to 'z' are considered letters, all other bytes are compared as they are.
+ */
+class CaseConversion final
+{
+public:
+
+    static constexpr char toLowerCase (char c) noexcept
+    {
+        return (c >= 'A' && c <= 'Z') ? static_cast<char> (c | 0x20) : c;
+    }
+
+
+    static constexpr char toUpperCase (char c) noexcept
+    {
+        return (c >= 'a' && c <= 'z') ? static_cast<char> (c & ~0x20) : c;
+    }
+
+
+    /** Writes the source in lower case to the destination, which is allowed to be the source itself. */
+    static void writeLowerCased (char* destination, const char* source, int numChars) noexcept
+    {
+        writeCaseToggled (destination, source, numChars, 'A', 'Z');
+    }
+
+
+    /** Writes the source in upper case to the destination, which is allowed to be the source itself. */
+    static void writeUpperCased (char* destination, const char* source, int numChars) noexcept
+    {
+        writeCaseToggled (destination, source, numChars, 'a', 'z');
+    }
+
+
+    /** Returns the number of chars at the start of both strings that are equal, ignoring case. */
+    static int numEqualCharsIgnoreCase (const char* s1, const char* s2, int numChars) noexcept
+    {
+        auto index = skipEqualBlocksIgnoreCase (s1, s2, numChars);
+
+        while (index < numChars && toLowerCase (s1[index]) == toLowerCase (s2[index]))
+            ++index;
+
+        return index;
+    }
+
+
+    static bool equalsIgnoreCase (const char* s1, const char* s2, int numChars) noexcept
+    {
+        return numEqualCharsIgnoreCase (s1, s2, numChars) == numChars;
+    }
+
+
+    /** Compares like StringHelpers::compare does, but without considering case. */
+    static int compareIgnoreCase (const char* s1, int len1, const char* s2, int len2) noexcept
+    {
+        auto numToCompare = len1 < len2 ? len1 : len2;
+        auto index = numEqualCharsIgnoreCase (s1, s2, numToCompare);
+
+        if (index < numToCompare)
+            return toLowerCase (s1[index]) > toLowerCase (s2[index]) ? 1 : -1;
+
+        return len1 == len2 ? 0 : (len1 > len2 ? 1 : -1);
+    }
+
+
+    /** Returns the index of the first occurrence of the needle in the haystack ignoring case, or -1. */
+    static int findIgnoreCase (const char* haystack, int haystackLength, const char* needle, int needleLength) noexcept
+    {
+        if (needleLength <= 0)
+            return 0;
+
+        if (needleLength > haystackLength)
+            return -1;
+
+       #if HOSA_AVX2_DISPATCH
+        if (CpuFeatures::hasAVX2())
+            return findIgnoreCaseAVX2 (haystack, haystackLength, needle, needleLength);
+       #endif
+
+       #if HOSA_SSE2
+        return findIgnoreCaseSSE2 (haystack, haystackLength, needle, needleLength);
+       #else
+        return findIgnoreCaseScalar (haystack, haystackLength, needle, needleLength, 0);
+       #endif
+    }
+
+private:
+
+    // toggles the case of all chars in the given range, which is all that's needed to go
+    // from upper to lower case or the other way around
+    static void writeCaseToggled (char* destination, const char* source, int numChars,
+                                  char rangeStart, char rangeEnd) noexcept
+    {
+        auto index = writeCaseToggledBlocks (destination, source, numChars, rangeStart, rangeEnd);
+
+        for (; index < numChars; ++index)
+        {
+            auto c = source[index];
+            destination[index] = (c >= rangeStart && c <= rangeEnd) ? static_cast<char> (c ^ 0x20) : c;
+        }
+    }
+
+
+    static int writeCaseToggledBlocks (char* destination, const char* source, int numChars,
+                                       char rangeStart, char rangeEnd) noexcept
+    {
+       #if HOSA_AVX2_DISPATCH
+        if (CpuFeatures::hasAVX2())
+            return writeCaseToggledBlocksAVX2 (destination, source, numChars, rangeStart, rangeEnd);
+       #endif
+
+       #if HOSA_SSE2
+        return writeCaseToggledBlocksSSE2 (destination, source, numChars, rangeStart, rangeEnd);
+       #else
+        return 0;
+       #endif
+    }
+
+
+    static int skipEqualBlocksIgnoreCase (const char* s1, const char* s2, int numChars) noexcept
+    {
+       #if HOSA_AVX2_DISPATCH
+        if (CpuFeatures::hasAVX2())
+            return skipEqualBlocksIgnoreCaseAVX2 (s1, s2, numChars);
+       #endif
+
+       #if HOSA_SSE2
+        return skipEqualBlocksIgnoreCaseSSE2 (s1, s2, numChars);
+       #else
+        return 0;
+       #endif
+    }
+
+
+    static int findIgnoreCaseScalar (const char* haystack, int haystackLength,
+                                     const char* needle, int needleLength, int startIndex) noexcept
+    {
+        auto first = toLowerCase (needle[0]);
+
+        for (; startIndex <= haystackLength - needleLength; ++startIndex)
+            if (toLowerCase (haystack[startIndex]) == first
+                && equalsIgnoreCase (haystack + startIndex, needle, needleLength))
+                return startIndex;
+
+        return -1;
+    }
+
+
+   #if HOSA_SSE2
+    static __m128i toLowerCaseSSE2 (__m128i chars) noexcept
+    {
+        auto isUpperCase = _mm_and_si128 (_mm_cmpgt_epi8 (chars, _mm_set1_epi8 ('A' - 1)),
+                                          _mm_cmpgt_epi8 (_mm_set1_epi8 ('Z' + 1), chars));
+        return _mm_or_si128 (chars, _mm_and_si128 (isUpperCase, _mm_set1_epi8 (0x20)));
+    }
+
+
+    static __m128i loadSSE2 (const char* source) noexcept
+    {
+        return _mm_loadu_si128 (reinterpret_cast<const __m128i*> (source));
+    }
+
+
+    static int writeCaseToggledBlocksSSE2 (char* destination, const char* source, int numChars,
+                                           char rangeStart, char rangeEnd) noexcept
+    {
+        auto belowRange = _mm_set1_epi8 (static_cast<char> (rangeStart - 1));
+        auto aboveRange = _mm_set1_epi8 (static_cast<char> (rangeEnd + 1));
+        auto caseBit = _mm_set1_epi8 (0x20);
+        auto index = 0;
+
+        for (; index + 16 <= numChars; index += 16)
+        {
+            auto chars = loadSSE2 (source + index);
+            auto inRange = _mm_and_si128 (_mm_cmpgt_epi8 (chars, belowRange), _mm_cmpgt_epi8 (aboveRange, chars));
+            auto toggled = _mm_xor_si128 (chars, _mm_and_si128 (inRange, caseBit));
+            _mm_storeu_si128 (reinterpret_cast<__m128i*> (destination + index), toggled);
+        }
+
+        return index;
+    }
+
+
+    static int skipEqualBlocksIgnoreCaseSSE2 (const char* s1, const char* s2, int numChars) noexcept
+    {
+        auto index = 0;
+
+        for (; index + 16 <= numChars; index += 16)
+        {
+            auto equal = _mm_cmpeq_epi8 (toLowerCaseSSE2 (loadSSE2 (s1 + index)), toLowerCaseSSE2 (loadSSE2 (s2 + index)));
+            auto mask = static_cast<unsigned int> (_mm_movemask_epi8 (equal));
+
+            if (mask != 0xffffu)
+                return index + CpuFeatures::countTrailingZeros (~mask);
+        }
+
+        return index;
+    }
+
+
+    static int findIgnoreCaseSSE2 (const char* haystack, int haystackLength, const char* needle, int needleLength) noexcept
+    {
+        auto first = _mm_set1_epi8 (toLowerCase (needle[0]));
+        auto last  = _mm_set1_epi8 (toLowerCase (needle[needleLength - 1]));
+        auto index = 0;
+
+        for (; index + 16 + needleLength - 1 <= haystackLength; index += 16)
+        {
+            auto blockFirst = toLowerCaseSSE2 (loadSSE2 (haystack + index));
+            auto blockLast  = toLowerCaseSSE2 (loadSSE2 (haystack + index + needleLength - 1));
+            auto matches = _mm_and_si128 (_mm_cmpeq_epi8 (first, blockFirst), _mm_cmpeq_epi8 (last, blockLast));
+            auto mask = static_cast<unsigned int> (_mm_movemask_epi8 (matches));
+
+            while (mask != 0)
+            {
+                auto candidate = index + CpuFeatures::countTrailingZeros (mask);
+
+                if (equalsIgnoreCase (haystack + candidate, needle, needleLength))
+                    return candidate;
+
+                mask &= mask - 1;
+            }
+        }
+
+        return findIgnoreCaseScalar (haystack, haystackLength, needle, needleLength, index);
+    }
+   #endif
+
+
+   #if HOSA_AVX2_DISPATCH
+    HOSA_TARGET_AVX2
+    static __m256i toLowerCaseAVX2 (__m256i chars) noexcept
+    {
+        auto isUpperCase = _mm256_and_si256 (_mm256_cmpgt_epi8 (chars, _mm256_set1_epi8 ('A' - 1)),
+                                             _mm256_cmpgt_epi8 (_mm256_set1_epi8 ('Z' + 1), chars));
+        return _mm256_or_si256 (chars, _mm256_and_si256 (isUpperCase, _mm256_set1_epi8 (0x20)));
+    }
+
+
+    HOSA_TARGET_AVX2
+    static __m256i loadAVX2 (const char* source) noexcept
+    {
+        return _mm256_loadu_si256 (reinterpret_cast<const __m256i*> (source));
+    }
+
+
+    HOSA_TARGET_AVX2
+    static int writeCaseToggledBlocksAVX2 (char* destination, const char* source, int numChars,
+                                           char rangeStart, char rangeEnd) noexcept
+    {
+        auto belowRange = _mm256_set1_epi8 (static_cast<char> (rangeStart - 1));
+        auto aboveRange = _mm256_set1_epi8 (static_cast<char> (rangeEnd + 1));
+        auto caseBit = _mm256_set1_epi8 (0x20);
+        auto index = 0;
+
+        for (; index + 32 <= numChars; index += 32)
+        {
+            auto chars = loadAVX2 (source + index);
+            auto inRange = _mm256_and_si256 (_mm256_cmpgt_epi8 (chars, belowRange), _mm256_cmpgt_epi8 (aboveRange, chars));
+            auto toggled = _mm256_xor_si256 (chars, _mm256_and_si256 (inRange, caseBit));
+            _mm256_storeu_si256 (reinterpret_cast<__m256i*> (destination + index), toggled);
+        }
+
+        return index;
+    }
+
+
+    HOSA_TARGET_AVX2
+    static int skipEqualBlocksIgnoreCaseAVX2 (const char* s1, const char* s2, int numChars) noexcept
+    {
+        auto index = 0;
+
+        for (; index + 32 <= numChars; index += 32)
+        {
+            auto equal = _mm256_cmpeq_epi8 (toLowerCaseAVX2 (loadAVX2 (s1 + index)), toLowerCaseAVX2 (loadAVX2 (s2 + index)));
+            auto mask = static_cast<unsigned int> (_mm256_movemask_epi8 (equal));
+
+            if (mask != 0xffffffffu)
+                return index + CpuFeatures::countTrailingZeros (~mask);
+        }
+
+        return index;
+    }
+
+
+    HOSA_TARGET_AVX2
+    static int findIgnoreCaseAVX2 (const char* haystack, int haystackLength, const char* needle, int needleLength) noexcept
+    {
+        auto first = _mm256_set1_epi8 (toLowerCase (needle[0]));
+        auto last  = _mm256_set1_epi8 (toLowerCase (needle[needleLength - 1]));
+        auto index = 0;
+
+        for (; index + 32 + needleLength - 1 <= haystackLength; index += 32)
+        {
+            auto blockFirst = toLowerCaseAVX2 (loadAVX2 (haystack + index));
+            auto blockLast  = toLowerCaseAVX2 (loadAVX2 (haystack + index + needleLength - 1));
+            auto matches = _mm256_and_si256 (_mm256_cmpeq_epi8 (first, blockFirst), _mm256_cmpeq_epi8 (last, blockLast));
+            auto mask = static_cast<unsigned int> (_mm256_movemask_epi8 (matches));
+
+            while (mask != 0)
+            {
+                auto candidate = index + CpuFeatures::countTrailingZeros (mask);
+
+                if (equalsIgnoreCase (haystack + candidate, needle, needleLength))
+                    return candidate;
+
+                mask &= mask - 1;
+            }
+        }
+
+        return findIgnoreCaseScalar (haystack, haystackLength, needle, needleLength, index);
+    }
+   #endif
+};
+
+} // namespace hosa::details
@@ -0,0 +1,236 @@
+/*
+    Copyright (C)2020 Wouter Ensink
+
+    This file is part of the Hosa [Header Only String & Array] C++ Project
+        - see the github page to find out more: www.github.com/w-ensink/hosa
+
+    The code in this file is provided under the terms of the ISC license:
+    Permission to use, copy, modify, and/or distribute this software for any purpose with
+    or without fee is hereby granted, provided that the above copyright notice and this
+    permission notice appear in all copies.
+
+    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO
+    THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT
+    SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR
+    ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF
+    CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE
+    OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+
+#pragma once
+
+#include <ostream>
+#include <type_traits>
+#include <utility>
+#include "hosa_String.h"
+
+namespace hosa
+{
+
+namespace details
+{
+
+/** A number that is part of a concatenation, rendered as soon as it's added to one. */
+class ConcatenatedNumber final
+{
+public:
+
+    template <typename IntegerType, IntegerNumberType<IntegerType, int> = 0>
+    explicit ConcatenatedNumber (IntegerType value) noexcept
+        : numChars (NumberFormatting::writeInteger (buffer, value))
+    {
+    }
+
+    explicit ConcatenatedNumber (double value) noexcept
+        : numChars (NumberFormatting::writeDouble (buffer, value))
+    {
+    }
+
+    [[nodiscard]] StringView view() const noexcept { return { buffer, numChars }; }
+
+private:
+
+    char buffer[NumberFormatting::maxCharsForWideInteger];
+    int numChars;
+};
+
+
+template <typename Lhs, typename Rhs>
+class Concatenation;
+
+
+// what each kind of operand is kept as: Strings that are about to go away are moved in,
+// all other text is referred to, numbers are rendered
+inline StringView         toConcatenationPart (const String& string) noexcept  { return string.view();   }
+inline String             toConcatenationPart (String&& string) noexcept       { return std::move (string); }
+inline StringView         toConcatenationPart (StringView view) noexcept       { return view;            }
+inline StringView         toConcatenationPart (const char* string) noexcept    { return string;          }
+inline char               toConcatenationPart (char character) noexcept        { return character;       }
+inline ConcatenatedNumber toConcatenationPart (double value) noexcept          { return ConcatenatedNumber (value); }
+
+template <typename IntegerType, IntegerNumberType<IntegerType, int> = 0>
+ConcatenatedNumber toConcatenationPart (IntegerType value) noexcept { return ConcatenatedNumber (value); }
+
+template <typename Lhs, typename Rhs>
+Concatenation<Lhs, Rhs> toConcatenationPart (const Concatenation<Lhs, Rhs>& concatenation) { return concatenation; }
+
+template <typename Lhs, typename Rhs>
+Concatenation<Lhs, Rhs> toConcatenationPart (Concatenation<Lhs, Rhs>&& concatenation) noexcept { return std::move (concatenation); }
+
+
+inline int   partLength (StringView view) noexcept                          { return view.length(); }
+inline int   partLength (const String& string) noexcept                     { return string.length(); }
+inline int   partLength (char) noexcept                                     { return 1; }
+inline int   partLength (const ConcatenatedNumber& number) noexcept         { return number.view().length(); }
+
+inline char* writePart (char* destination, StringView view) noexcept
+{
+    memcpy (destination, view.data(), (std::size_t) view.length());
+    return destination + view.length();
+}
+
+inline char* writePart (char* destination, const String& string) noexcept          { return writePart (destination, string.view()); }
+inline char* writePart (char* destination, const ConcatenatedNumber& number) noexcept { return writePart (destination, number.view()); }
+
+inline char* writePart (char* destination, char character) noexcept
+{
+    *destination = character;
+    return destination + 1;
+}
+
+template <typename Lhs, typename Rhs>
+int partLength (const Concatenation<Lhs, Rhs>& concatenation) noexcept { return concatenation.length(); }
+
+template <typename Lhs, typename Rhs>
+char* writePart (char* destination, const Concatenation<Lhs, Rhs>& concatenation) noexcept { return concatenation.writeTo (destination); }
+
+
+/** The result of adding texts, chars and numbers to a String with operator+.
+
+    Nothing gets copied until the whole chain is turned into a String, or appended to one,
+    at which point the total length is known and everything is written into a single buffer.
+    Operands are referred to rather than copied, so a concatenation should be turned into a
+    String right away instead of being kept around with auto.
+ */
+template <typename Lhs, typename Rhs>
+class Concatenation final
+{
+public:
+
+    Concatenation (Lhs&& lhs, Rhs&& rhs) noexcept
+        : lhs (std::move (lhs)), rhs (std::move (rhs))
+    {
+    }
+
+    [[nodiscard]] int length() const noexcept
+    {
+        return partLength (lhs) + partLength (rhs);
+    }
+
+    /** Writes all parts to the destination, which needs room for length() chars, and returns the end. */
+    char* writeTo (char* destination) const noexcept
+    {
+        return writePart (writePart (destination, lhs), rhs);
+    }
+
+    [[nodiscard]] String toString() const
+    {
+        auto result = String::withLength (length());
+        writeTo (result.text);
+        return result;
+    }
+
+    operator String() const { return toString(); }
+
+    void print() const { toString().print(); }
+
+
+    friend bool operator== (const Concatenation& lhs, StringView rhs) { return lhs.toString().view() == rhs; }
+    friend bool operator== (StringView lhs, const Concatenation& rhs) { return rhs == lhs; }
+    friend bool operator!= (const Concatenation& lhs, StringView rhs) { return ! (lhs == rhs); }
+    friend bool operator!= (StringView lhs, const Concatenation& rhs) { return ! (rhs == lhs); }
+
+    template <typename Traits>
+    friend std::basic_ostream<char, Traits>& operator<< (std::basic_ostream<char, Traits>& stream, const Concatenation& concatenation)
+    {
+        return stream << concatenation.toString();
+    }
+
+private:
+
+    Lhs lhs;
+    Rhs rhs;
+};
+
+
+template <typename Type>
+struct IsConcatenation : std::false_type {};
+
+template <typename Lhs, typename Rhs>
+struct IsConcatenation<Concatenation<Lhs, Rhs>> : std::true_type {};
+
+template <typename Type>
+using ConcatenationPart = decltype (toConcatenationPart (std::declval<Type>()));
+
+template <typename Type, typename = void>
+struct IsConcatenationPart : std::false_type {};
+
+template <typename Type>
+struct IsConcatenationPart<Type, std::void_t<ConcatenationPart<Type>>> : std::true_type {};
+
+// operator+ only makes a concatenation when at least one side is a string type of our own,
+// so adding a number to a const char* still does pointer arithmetic
+template <typename Type, typename Decayed = std::decay_t<Type>>
+constexpr bool isConcatenationOperand = std::is_same_v<Decayed, String> || std::is_same_v<Decayed, StringView>
+                                         || IsConcatenation<Decayed>::value;
+
+template <typename Lhs, typename Rhs>
+using ConcatenationType = std::enable_if_t<(isConcatenationOperand<Lhs> || isConcatenationOperand<Rhs>)
+                                            && IsConcatenationPart<Lhs>::value && IsConcatenationPart<Rhs>::value,
+                                           Concatenation<ConcatenationPart<Lhs>, ConcatenationPart<Rhs>>>;
+
+} // namespace details
+
+
+/** Concatenates Strings, views, C strings, chars and numbers, as long as at least one of
+    the two operands is a String or StringView, see details::Concatenation.
+ */
+template <typename Lhs, typename Rhs>
+details::ConcatenationType<Lhs, Rhs> operator+ (Lhs&& lhs, Rhs&& rhs)
+{
+    return { details::toConcatenationPart (std::forward<Lhs> (lhs)),
+             details::toConcatenationPart (std::forward<Rhs> (rhs)) };
+}
+
+
+template <typename Lhs, typename Rhs>
+String& String::append (const details::Concatenation<Lhs, Rhs>& concatenation)
+{
+    auto newLength = textLength + concatenation.length();
+
+    if (newLength <= allocatedSpace)
+    {
+        textLength = static_cast<int> (concatenation.writeTo (text + textLength) - text);
+        text[textLength] = '\0';
+        return *this;
+    }
+
+    // the concatenation might refer to this String, so its buffer has to stay around until it's written
+    auto result = String();
+    result.resource = resource;
+    result.ensureAllocatedSpace (newLength);
+    memcpy (result.text, text, (std::size_t) textLength);
+    result.textLength = static_cast<int> (concatenation.writeTo (result.text + textLength) - result.text);
+    result.text[result.textLength] = '\0';
+    return *this = std::move (result);
+}
+
+
+template <typename Lhs, typename Rhs>
+String& String::operator+= (const details::Concatenation<Lhs, Rhs>& concatenation)
+{
+    return append (concatenation);
+}
+
+} // namespace hosa
@@ -0,0 +1,211 @@
+/*
+    Copyright (C)2020 Wouter Ensink
+
+    This file is part of the Hosa [Header Only String & Array] C++ Project
+        - see the github page to find out more: www.github.com/w-ensink/hosa
+
+    The code in this file is provided under the terms of the ISC license:
+    Permission to use, copy, modify, and/or distribute this software for any purpose with
+    or without fee is hereby granted, provided that the above copyright notice and this
+    permission notice appear in all copies.
+
+    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO
+    THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT
+    SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR
+    ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF
+    CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE
+    OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+
+#pragma once
+
+#include <array>
+#include <utility>
+#include "hosa_String.h"
+
+namespace hosa
+{
+
+/** A format string that has been taken apart at compile time.
+
+    The pattern is split into the literal pieces around its {} places while compiling,
+    so formatting only has to copy those pieces and the arguments into a single allocation.
+    Passing a different number of arguments than there are {} places won't compile.
+
+    You normally don't spell out this type, but get one from the _fmt literal:
+    @code
+    auto line = "{} took {} ms"_fmt.format (taskName, milliSeconds);
+    @endcode
+    or, when compiling as C++20, from hosa::fmt<"{} took {} ms">.
+ */
+template <char... Chars>
+class FormatString final
+{
+public:
+
+    static constexpr int patternLength = static_cast<int> (sizeof... (Chars));
+
+    static constexpr int numPlaces = []
+    {
+        constexpr char pattern[] = { Chars..., '\0' };
+        auto num = 0;
+
+        for (auto i = 0; i < patternLength - 1; ++i)
+        {
+            if (pattern[i] == '{' && pattern[i + 1] == '}')
+            {
+                ++num;
+                ++i;
+            }
+        }
+
+        return num;
+    }();
+
+    // the number of chars in the result that come from the pattern itself
+    static constexpr int numLiteralChars = patternLength - 2 * numPlaces;
+
+
+    template <typename... Arguments>
+    [[nodiscard]] String format (const Arguments&... arguments) const
+    {
+        static_assert (sizeof... (Arguments) == numPlaces,
+                       "The number of arguments doesn't match the number of {} in the format string");
+
+        const std::array<details::StringHelpers::FormatArgument, sizeof... (Arguments)> formatArguments { arguments... };
+        auto length = numLiteralChars;
+
+        for (auto& argument : formatArguments)
+            length += argument.length;
+
+        auto result = String::withLength (length);
+        auto* destination = result.text;
+
+        for (auto i = 0; i < numPlaces; ++i)
+        {
+            destination = writeSegment (destination, segments[(std::size_t) i]);
+            memcpy (destination, formatArguments[(std::size_t) i].text, (std::size_t) formatArguments[(std::size_t) i].length);
+            destination += formatArguments[(std::size_t) i].length;
+        }
+
+        writeSegment (destination, segments[(std::size_t) numPlaces]);
+        return result;
+    }
+
+
+    [[nodiscard]] static constexpr const char* toRawUTF8() noexcept { return pattern; }
+
+private:
+
+    struct Segment
+    {
+        int start = 0;
+        int length = 0;
+    };
+
+
+    static constexpr char pattern[] = { Chars..., '\0' };
+
+    // the literal text before each {} place, plus the text after the last one
+    static constexpr std::array<Segment, numPlaces + 1> segments = []
+    {
+        std::array<Segment, numPlaces + 1> result {};
+        auto segmentIndex = 0;
+        auto start = 0;
+
+        for (auto i = 0; i < patternLength - 1; ++i)
+        {
+            if (pattern[i] == '{' && pattern[i + 1] == '}')
+            {
+                result[(std::size_t) segmentIndex++] = { start, i - start };
+                start = ++i + 1;
+            }
+        }
+
+        result[(std::size_t) segmentIndex] = { start, patternLength - start };
+        return result;
+    }();
+
+
+    static char* writeSegment (char* destination, Segment segment) noexcept
+    {
+        memcpy (destination, pattern + segment.start, (std::size_t) segment.length);
+        return destination + segment.length;
+    }
+};
+
+
+// ===============================================================================================
+
+#if __cpp_nontype_template_args >= 201911L
+
+namespace details
+{
+    template <std::size_t Size>
+    struct FixedString
+    {
+        constexpr FixedString (const char (&string)[Size])
+        {
+            for (std::size_t i = 0; i < Size; ++i)
+                text[i] = string[i];
+        }
+
+        char text[Size] {};
+    };
+
+
+    template <FixedString Pattern, std::size_t... Indices>
+    constexpr auto makeFormatString (std::index_sequence<Indices...>)
+    {
+        return FormatString<Pattern.text[Indices]...>();
+    }
+}
+
+/** A compile time format string, for example: hosa::fmt<"{} = {}">.format (name, value) */
+template <details::FixedString Pattern>
+inline constexpr auto fmt = details::makeFormatString<Pattern> (std::make_index_sequence<sizeof (Pattern.text) - 1>());
+
+namespace literals
+{
+    template <details::FixedString Pattern>
+    constexpr auto operator"" _fmt()
+    {
+        return fmt<Pattern>;
+    }
+}
+
+using literals::operator""_fmt;
+
+#elif defined (__GNUC__) || defined (__clang__)
+
+namespace literals
+{
+   // string literal operator templates are a GNU extension before C++20, supported by both gcc and clang
+   #if defined (__clang__)
+    #pragma clang diagnostic push
+    #pragma clang diagnostic ignored "-Wgnu-string-literal-operator-template"
+   #else
+    #pragma GCC diagnostic push
+    #pragma GCC diagnostic ignored "-Wpedantic"
+   #endif
+
+    template <typename CharType, CharType... Chars>
+    constexpr FormatString<Chars...> operator"" _fmt()
+    {
+        static_assert (std::is_same_v<CharType, char>, "Only char format strings are supported");
+        return {};
+    }
+
+   #if defined (__clang__)
+    #pragma clang diagnostic pop
+   #else
+    #pragma GCC diagnostic pop
+   #endif
+}
+
+using literals::operator""_fmt;
+
+#endif
+
+} // namespace hosa
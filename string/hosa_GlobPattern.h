@@ -0,0 +1,424 @@
+/*
+    Copyright (C)2020 Wouter Ensink
+
+    This file is part of the Hosa [Header Only String & Array] C++ Project
+        - see the github page to find out more: www.github.com/w-ensink/hosa
+
+    The code in this file is provided under the terms of the ISC license:
+    Permission to use, copy, modify, and/or distribute this software for any purpose with
+    or without fee is hereby granted, provided that the above copyright notice and this
+    permission notice appear in all copies.
+
+    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO
+    THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT
+    SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR
+    ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF
+    CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE
+    OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include "../array/hosa_Array.h"
+#include "hosa_CaseConversion.h"
+#include "hosa_String.h"
+#include "hosa_StringSearch.h"
+#include "hosa_StringView.h"
+
+namespace hosa
+{
+
+/** A wildcard pattern like "*.log" or "api/v?/users", compiled once to be matched against many texts.
+
+    A * matches any number of chars (also none), a ? matches exactly one char (one byte, so
+    a multi byte UTF-8 char takes more than one), and a backslash makes the char after it match
+    only itself. Everything else matches itself, or either case of itself when ignoring case
+    (for 'A' to 'Z' and 'a' to 'z').
+
+    Compiling looks at the shape of the pattern, and picks the fastest way to match it:
+    a plain comparison for patterns without wildcards, a prefix, suffix or substring check for
+    patterns like "abc*", "*abc" and "*abc*" (the last one for up to 64 chars between the *s),
+    and the general matcher for everything else.
+    The general matcher splits the pattern at its *s, and finds every part at the first place it
+    fits after the previous one, so it never has to backtrack and every char of the text is looked
+    at by only one part. Parts of up to 64 chars are found with a bit-parallel shift-and, and longer
+    parts without ?s with Knuth-Morris-Pratt, both in linear time whatever the text looks like.
+    Only parts longer than 64 chars that contain ?s take more: a shift-and that does one step per
+    64 chars of the part for every char of the text.
+
+    @code
+    auto logFiles = GlobPattern ("*.log", true);
+
+    for (auto index : logFiles.findMatches (fileNames))
+        ...
+    @endcode
+ */
+class GlobPattern final
+{
+public:
+
+    enum class Shape
+    {
+        literal,        // abc
+        prefix,         // abc*
+        suffix,         // *abc
+        substring,      // *abc*
+        general         // anything else
+    };
+
+    GlobPattern() : GlobPattern (StringView()) {}
+
+    explicit GlobPattern (StringView pattern, bool shouldIgnoreCase = false)
+        : ignoreCase (shouldIgnoreCase)
+    {
+        compile (pattern);
+    }
+
+    [[nodiscard]] Shape getShape() const noexcept { return shape; }
+    [[nodiscard]] bool isIgnoringCase() const noexcept { return ignoreCase; }
+
+    //==============================================================================
+
+    /** True if the whole text matches the pattern. */
+    [[nodiscard]] bool matches (StringView text) const noexcept
+    {
+        switch (shape)
+        {
+            case Shape::literal:   return text.length() == literal.length() && equalAt (text, 0, literal);
+            case Shape::prefix:    return text.length() >= literal.length() && equalAt (text, 0, literal);
+            case Shape::suffix:    return text.length() >= literal.length() && equalAt (text, text.length() - literal.length(), literal);
+            case Shape::substring: return find (text, 0, literal) >= 0;
+            default:               return matchesGeneral (text);
+        }
+    }
+
+    /** Returns the indices of the texts that match, in order. */
+    [[nodiscard]] Array<int> findMatches (const Array<String>& texts) const
+    {
+        auto result = Array<int>();
+
+        for (auto i = 0; i < texts.getNumItems(); ++i)
+            if (matches (texts[i].view()))
+                result.add (i);
+
+        return result;
+    }
+
+    /** Returns the number of texts that match. */
+    [[nodiscard]] int countMatches (const Array<String>& texts) const noexcept
+    {
+        auto num = 0;
+
+        for (auto& text : texts)
+            if (matches (text.view()))
+                ++num;
+
+        return num;
+    }
+
+private:
+
+    // the chars between two *s: literal text, where the positions of any ?s are marked
+    struct Part
+    {
+        String text;
+        Array<bool> isAnyChar;
+        bool hasAnyChars = false;
+
+        // for the shift-and search of middle parts: numMaskWords words per byte value,
+        // where bit i is set when that byte fits at position i of the part
+        Array<std::uint64_t> charMasks;
+        int numMaskWords = 0;
+
+        // for the Knuth-Morris-Pratt search of long middle parts without ?s: the length of the
+        // longest proper prefix of the first i + 1 chars that is also a suffix of them
+        Array<int> borderLengths;
+    };
+
+    void compile (StringView pattern)
+    {
+        parts.add (Part());
+
+        for (auto i = 0; i < pattern.length(); ++i)
+        {
+            auto c = pattern[i];
+
+            if (c == '*')
+            {
+                parts.add (Part());
+                continue;
+            }
+
+            auto isAnyChar = c == '?';
+
+            if (c == '\\' && i + 1 < pattern.length())
+                c = pattern[++i];
+
+            auto& part = parts[parts.getNumItems() - 1];
+            part.text += ignoreCase ? details::CaseConversion::toLowerCase (c) : c;
+            part.isAnyChar.add (isAnyChar);
+            part.hasAnyChars |= isAnyChar;
+        }
+
+        // the first and last part have to be at the start and end of the text (and are empty when the
+        // pattern starts or ends with a *), empty parts in between come from rows of *s and don't matter
+        for (auto i = parts.getNumItems() - 2; i > 0; --i)
+            if (parts[i].text.length() == 0)
+                parts.remove (i);
+
+        auto numParts = parts.getNumItems();
+        auto anyChars = false;
+
+        for (auto& part : parts)
+            anyChars |= part.hasAnyChars;
+
+        auto& first = parts[0];
+        auto& last = parts[numParts - 1];
+
+        if (anyChars)
+            shape = Shape::general;
+        else if (numParts == 1)
+            setLiteralShape (Shape::literal, first.text);
+        else if (numParts == 2 && last.text.length() == 0)
+            setLiteralShape (Shape::prefix, first.text);
+        else if (numParts == 2 && first.text.length() == 0)
+            setLiteralShape (Shape::suffix, last.text);
+        else if (numParts == 3 && first.text.length() == 0 && last.text.length() == 0 && parts[1].text.length() <= 64)
+            setLiteralShape (Shape::substring, parts[1].text);
+        else
+            shape = Shape::general;
+
+        if (shape == Shape::general)
+        {
+            for (auto i = 1; i < numParts - 1; ++i)
+            {
+                if (parts[i].hasAnyChars || parts[i].text.length() <= 64)
+                    buildCharMasks (parts[i]);
+                else
+                    buildBorderLengths (parts[i]);
+            }
+        }
+    }
+
+    void setLiteralShape (Shape newShape, const String& text)
+    {
+        shape = newShape;
+        literal = text;
+    }
+
+    static void buildBorderLengths (Part& part)
+    {
+        auto length = part.text.length();
+        part.borderLengths.ensureAllocatedSpace (length);
+        part.borderLengths.add (0);
+
+        for (auto i = 1, border = 0; i < length; ++i)
+        {
+            while (border > 0 && part.text[i] != part.text[border])
+                border = part.borderLengths[border - 1];
+
+            if (part.text[i] == part.text[border])
+                ++border;
+
+            part.borderLengths.add (border);
+        }
+    }
+
+    void buildCharMasks (Part& part) const
+    {
+        auto length = part.text.length();
+        part.numMaskWords = (length + 63) / 64;
+        part.charMasks.ensureAllocatedSpace (256 * part.numMaskWords);
+
+        for (auto i = 0; i < 256 * part.numMaskWords; ++i)
+            part.charMasks.add (0);
+
+        auto setBit = [&] (unsigned char c, int position)
+        {
+            part.charMasks[c * part.numMaskWords + position / 64] |= std::uint64_t (1) << (position % 64);
+        };
+
+        for (auto i = 0; i < length; ++i)
+        {
+            auto c = static_cast<unsigned char> (part.text[i]);
+
+            if (part.isAnyChar[i])
+            {
+                for (auto anyChar = 0; anyChar < 256; ++anyChar)
+                    setBit (static_cast<unsigned char> (anyChar), i);
+            }
+            else
+            {
+                setBit (c, i);
+
+                // the text is already in lower case, so the other case only has to be added here
+                if (ignoreCase && c >= 'a' && c <= 'z')
+                    setBit (static_cast<unsigned char> (c - 'a' + 'A'), i);
+            }
+        }
+    }
+
+    //==============================================================================
+
+    bool equalAt (StringView text, int index, const String& toCompare) const noexcept
+    {
+        if (ignoreCase)
+            return details::CaseConversion::equalsIgnoreCase (text.data() + index, toCompare.toRawUTF8(), toCompare.length());
+
+        return memcmp (text.data() + index, toCompare.toRawUTF8(), (std::size_t) toCompare.length()) == 0;
+    }
+
+    int find (StringView text, int startIndex, const String& toFind) const noexcept
+    {
+        auto index = ignoreCase
+            ? details::CaseConversion::findIgnoreCase (text.data() + startIndex, text.length() - startIndex, toFind.toRawUTF8(), toFind.length())
+            : details::StringSearch::find (text.data() + startIndex, text.length() - startIndex, toFind.toRawUTF8(), toFind.length());
+
+        return index < 0 ? -1 : startIndex + index;
+    }
+
+    bool partMatchesAt (StringView text, int index, const Part& part) const noexcept
+    {
+        if (! part.hasAnyChars)
+            return equalAt (text, index, part.text);
+
+        for (auto i = 0; i < part.text.length(); ++i)
+        {
+            auto c = text[index + i];
+
+            if (! part.isAnyChar[i] && (ignoreCase ? details::CaseConversion::toLowerCase (c) : c) != part.text[i])
+                return false;
+        }
+
+        return true;
+    }
+
+    // the first place at or after the start index where the part fits, or -1
+    int findPart (StringView text, int startIndex, const Part& part) const noexcept
+    {
+        if (part.numMaskWords == 1)
+            return findWithShiftAnd (text, startIndex, part);
+
+        if (part.hasAnyChars)
+            return findWithLongShiftAnd (text, startIndex, part);
+
+        return findWithKnuthMorrisPratt (text, startIndex, part);
+    }
+
+    // the number of matched chars only goes back as far as the part allows after a mismatch,
+    // so every char of the text is compared a constant number of times on average
+    int findWithKnuthMorrisPratt (StringView text, int startIndex, const Part& part) const noexcept
+    {
+        auto length = part.text.length();
+        auto numMatched = 0;
+
+        for (auto index = startIndex; index < text.length(); ++index)
+        {
+            auto c = ignoreCase ? details::CaseConversion::toLowerCase (text[index]) : text[index];
+
+            while (numMatched > 0 && c != part.text[numMatched])
+                numMatched = part.borderLengths[numMatched - 1];
+
+            if (c == part.text[numMatched] && ++numMatched == length)
+                return index - length + 1;
+        }
+
+        return -1;
+    }
+
+    // bit i of the state is set when the last i + 1 chars fit the first i + 1 chars of the part,
+    // so the part has been found when the bit of its last char gets set
+    static int findWithShiftAnd (StringView text, int startIndex, const Part& part) noexcept
+    {
+        auto* masks = part.charMasks.begin();
+        auto length = part.text.length();
+        auto foundBit = std::uint64_t (1) << (length - 1);
+        auto state = std::uint64_t (0);
+
+        for (auto index = startIndex; index < text.length(); ++index)
+        {
+            state = ((state << 1) | 1) & masks[static_cast<unsigned char> (text[index])];
+
+            if ((state & foundBit) != 0)
+                return index - length + 1;
+        }
+
+        return -1;
+    }
+
+    // the same for parts of more than 64 chars, with the state spread over several words
+    static int findWithLongShiftAnd (StringView text, int startIndex, const Part& part) noexcept
+    {
+        constexpr int maxNumWordsOnStack = 16;
+        auto numWords = part.numMaskWords;
+        auto length = part.text.length();
+        auto foundBit = std::uint64_t (1) << ((length - 1) % 64);
+
+        std::uint64_t stateOnStack[maxNumWordsOnStack] = {};
+        auto stateOnHeap = std::unique_ptr<std::uint64_t[]> (numWords > maxNumWordsOnStack ? new std::uint64_t[(std::size_t) numWords]() : nullptr);
+        auto* state = stateOnHeap != nullptr ? stateOnHeap.get() : stateOnStack;
+
+        for (auto index = startIndex; index < text.length(); ++index)
+        {
+            auto* mask = part.charMasks.begin() + static_cast<unsigned char> (text[index]) * numWords;
+            auto carry = std::uint64_t (1);
+
+            for (auto word = 0; word < numWords; ++word)
+            {
+                auto shiftedOut = state[word] >> 63;
+                state[word] = ((state[word] << 1) | carry) & mask[word];
+                carry = shiftedOut;
+            }
+
+            if ((state[numWords - 1] & foundBit) != 0)
+                return index - length + 1;
+        }
+
+        return -1;
+    }
+
+    bool matchesGeneral (StringView text) const noexcept
+    {
+        auto& first = parts[0];
+        auto numParts = parts.getNumItems();
+
+        if (numParts == 1)
+            return text.length() == first.text.length() && partMatchesAt (text, 0, first);
+
+        auto& last = parts[numParts - 1];
+
+        if (text.length() < first.text.length() + last.text.length()
+             || ! partMatchesAt (text, 0, first)
+             || ! partMatchesAt (text, text.length() - last.text.length(), last))
+            return false;
+
+        // the parts in between can be anywhere in what's left, taking the first place
+        // that fits for each of them leaves the most room for the ones after it
+        auto index = first.text.length();
+        auto end = text.length() - last.text.length();
+        auto middle = StringView (text.data(), end);
+
+        for (auto i = 1; i < numParts - 1; ++i)
+        {
+            index = findPart (middle, index, parts[i]);
+
+            if (index < 0)
+                return false;
+
+            index += parts[i].text.length();
+        }
+
+        return true;
+    }
+
+
+    bool ignoreCase;
+    Shape shape = Shape::literal;
+    String literal;
+    Array<Part> parts;
+};
+
+} // namespace hosa
@@ -0,0 +1,384 @@
+/*
+    Copyright (C)2020 Wouter Ensink
+
+    This file is part of the Hosa [Header Only String & Array] C++ Project
+        - see the github page to find out more: www.github.com/w-ensink/hosa
+
+    The code in this file is provided under the terms of the ISC license:
+    Permission to use, copy, modify, and/or distribute this software for any purpose with
+    or without fee is hereby granted, provided that the above copyright notice and this
+    permission notice appear in all copies.
+
+    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO
+    THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT
+    SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR
+    ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF
+    CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE
+    OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+
+#pragma once
+
+#include <cstdint>
+#include <initializer_list>
+#include "../array/hosa_Array.h"
+#include "hosa_String.h"
+#include "hosa_StringBuilder.h"
+#include "hosa_StringView.h"
+
+namespace hosa
+{
+
+/** Finds any number of patterns in a text in a single pass, with an Aho-Corasick automaton.
+
+    The patterns are compiled once into a deterministic automaton that's stored as one flat table:
+    bytes are first mapped to classes (all bytes that appear in no pattern share a class), and every
+    state is a row with the next state for each class. Stepping through the text costs one table
+    lookup per byte, however many patterns there are. The table takes (number of states) x (number
+    of classes, rounded up to a power of two) x 4 bytes, where the number of states is at most
+    the total length of all patterns.
+
+    @code
+    auto secrets = MultiPatternMatcher (secretWords);
+    auto redacted = secrets.replaceAll (message, "***");
+    @endcode
+ */
+class MultiPatternMatcher final
+{
+public:
+
+    struct Match
+    {
+        int patternIndex;
+        int start;
+        int length;
+    };
+
+    MultiPatternMatcher() { build ({}); }
+
+    /** Empty patterns are ignored. Matches report the index of the pattern in this array,
+        for duplicate patterns the index of the first one.
+     */
+    explicit MultiPatternMatcher (const Array<String>& patterns)
+    {
+        auto views = Array<StringView>();
+        views.ensureAllocatedSpace (patterns.getNumItems());
+
+        for (auto& pattern : patterns)
+            views.add (pattern.view());
+
+        build (views);
+    }
+
+    MultiPatternMatcher (std::initializer_list<StringView> patterns)
+    {
+        auto views = Array<StringView>();
+
+        for (auto pattern : patterns)
+            views.add (pattern);
+
+        build (views);
+    }
+
+    [[nodiscard]] int getNumPatterns() const noexcept { return patternLengths.getNumItems(); }
+
+    /** The number of states in the automaton, which is one more than the number of distinct pattern prefixes. */
+    [[nodiscard]] int getNumStates() const noexcept { return patternAtState.getNumItems(); }
+
+    //==============================================================================
+
+    /** Calls the callback with every match in the text, overlapping ones included,
+        in the order in which they end.
+     */
+    template <typename Callback>
+    void forEachMatch (StringView text, Callback&& callback) const
+    {
+        forEachMatchWithEnd (text, [&callback] (Match match, int) { callback (match); });
+    }
+
+    /** Returns all matches in the text, overlapping ones included, in the order in which they end. */
+    [[nodiscard]] Array<Match> findAll (StringView text) const
+    {
+        auto matches = Array<Match>();
+        forEachMatch (text, [&matches] (Match match) { matches.add (match); });
+        return matches;
+    }
+
+    /** True if any of the patterns occurs in the text. */
+    [[nodiscard]] bool containsAny (StringView text) const noexcept
+    {
+        auto* bytes = reinterpret_cast<const unsigned char*> (text.data());
+        auto row = 0;
+
+        for (auto i = 0; i < text.length(); ++i)
+        {
+            row = transitions[(row & ~hasMatchesFlag) + byteClasses[bytes[i]]];
+
+            if ((row & hasMatchesFlag) != 0)
+                return true;
+        }
+
+        return false;
+    }
+
+    /** Calls the callback with the matches that don't overlap, chosen from left to right:
+        of all matches that start at the leftmost position the longest one is taken, and
+        the search goes on after it. This is the set of matches replaceAll() replaces.
+     */
+    template <typename Callback>
+    void forEachLeftmostLongestMatch (StringView text, Callback&& callback) const
+    {
+        // matches are found by where they end, but chosen by where they start, which is only
+        // certain once the scan is a whole pattern length past that start: until then, the
+        // longest match per start is kept in a ring with room for that many starts
+        auto windowSize = maxPatternLength + 1;
+        auto longestPerStart = Array<Match>();
+        longestPerStart.ensureAllocatedSpace (windowSize);
+
+        for (auto i = 0; i < windowSize; ++i)
+            longestPerStart.add (Match { -1, 0, 0 });
+
+        auto nextStart = 0;
+        auto firstFreeIndex = 0;
+        auto numPending = 0;
+
+        auto decideUpTo = [&] (int end)
+        {
+            // without any matches waiting there's nothing to decide, so it can skip ahead
+            if (numPending == 0 && nextStart < end)
+                nextStart = end;
+
+            for (; nextStart < end; ++nextStart)
+            {
+                auto& longest = longestPerStart[nextStart % windowSize];
+
+                if (longest.length == 0)
+                    continue;
+
+                if (nextStart >= firstFreeIndex)
+                {
+                    callback (longest);
+                    firstFreeIndex = nextStart + longest.length;
+                }
+
+                longest.length = 0;
+
+                if (--numPending == 0)
+                    nextStart = end - 1;
+            }
+        };
+
+        forEachMatchWithEnd (text, [&] (Match match, int end)
+        {
+            decideUpTo (end - maxPatternLength);
+
+            auto& longest = longestPerStart[match.start % windowSize];
+
+            if (longest.length == 0)
+                ++numPending;
+
+            if (match.length > longest.length)
+                longest = match;
+        });
+
+        decideUpTo (text.length());
+    }
+
+    /** Returns the text with every leftmost longest match replaced by the replacement of its pattern
+        (the replacement at the same index as the pattern). The result is allocated only once.
+     */
+    [[nodiscard]] String replaceAll (StringView text, const Array<String>& replacements) const
+    {
+        return replaceMatches (text, [&replacements] (int pattern) { return replacements[pattern].view(); });
+    }
+
+    /** Returns the text with every leftmost longest match replaced by the same replacement. */
+    [[nodiscard]] String replaceAll (StringView text, StringView replacement) const
+    {
+        return replaceMatches (text, [replacement] (int) { return replacement; });
+    }
+
+private:
+
+    // like forEachMatch, but also gives the position the scan is at
+    template <typename Callback>
+    void forEachMatchWithEnd (StringView text, Callback&& callback) const
+    {
+        auto* bytes = reinterpret_cast<const unsigned char*> (text.data());
+        auto row = 0;
+
+        for (auto end = 1; end <= text.length(); ++end)
+        {
+            row = transitions[(row & ~hasMatchesFlag) + byteClasses[bytes[end - 1]]];
+
+            if ((row & hasMatchesFlag) == 0)
+                continue;
+
+            for (auto state = firstMatchAtState[row >> strideShift]; state >= 0; state = nextMatchAtState[state])
+            {
+                auto pattern = patternAtState[state];
+                callback (Match { pattern, end - patternLengths[pattern], patternLengths[pattern] }, end);
+            }
+        }
+    }
+
+    // measures the result first, so it can be written into a buffer of exactly the right size
+    template <typename ReplacementForPattern>
+    String replaceMatches (StringView text, ReplacementForPattern&& replacementFor) const
+    {
+        auto resultLength = text.length();
+
+        forEachLeftmostLongestMatch (text, [&] (Match match)
+        {
+            resultLength += replacementFor (match.patternIndex).length() - match.length;
+        });
+
+        auto builder = StringBuilder (resultLength);
+        auto copiedUpTo = 0;
+
+        forEachLeftmostLongestMatch (text, [&] (Match match)
+        {
+            builder.append (text.substring (copiedUpTo, match.start - copiedUpTo));
+            builder.append (replacementFor (match.patternIndex));
+            copiedUpTo = match.start + match.length;
+        });
+
+        builder.append (text.substring (copiedUpTo, text.length() - copiedUpTo));
+        return builder.release();
+    }
+
+    //==============================================================================
+
+    void build (const Array<StringView>& patterns)
+    {
+        // the bytes that occur in the patterns get a class each, all others share class 0
+        for (auto& byteClass : byteClasses)
+            byteClass = 0;
+
+        auto numClasses = 1;
+
+        for (auto& pattern : patterns)
+            for (auto c : pattern)
+                if (byteClasses[(unsigned char) c] == 0)
+                    byteClasses[(unsigned char) c] = (std::uint16_t) numClasses++;
+
+        // a row is at least two entries wide, which leaves the lowest bit of a row index free
+        strideShift = 1;
+
+        while ((1 << strideShift) < numClasses)
+            ++strideShift;
+
+        auto stride = 1 << strideShift;
+
+        // the trie of all patterns, where -1 means there's no edge yet
+        auto addState = [&]
+        {
+            for (auto i = 0; i < stride; ++i)
+                transitions.add (-1);
+
+            patternAtState.add (-1);
+            return patternAtState.getNumItems() - 1;
+        };
+
+        addState();
+        maxPatternLength = 0;
+
+        for (auto p = 0; p < patterns.getNumItems(); ++p)
+        {
+            auto state = 0;
+
+            for (auto c : patterns[p])
+            {
+                auto& next = transitions[state * stride + byteClasses[(unsigned char) c]];
+
+                if (next < 0)
+                {
+                    auto newState = addState();
+                    transitions[state * stride + byteClasses[(unsigned char) c]] = newState;
+                    state = newState;
+                }
+                else
+                {
+                    state = next;
+                }
+            }
+
+            patternLengths.add (patterns[p].length());
+
+            if (state != 0 && patternAtState[state] < 0)
+                patternAtState[state] = p;
+
+            if (patterns[p].length() > maxPatternLength)
+                maxPatternLength = patterns[p].length();
+        }
+
+        // breadth first, so the fallback of every state is done before the states below it: the missing
+        // edges of a state are those of its fallback (the state of its longest proper suffix)
+        auto numStates = patternAtState.getNumItems();
+        auto fallback = Array<int>();
+        auto queue = Array<int>();
+        fallback.ensureAllocatedSpace (numStates);
+        queue.ensureAllocatedSpace (numStates);
+
+        for (auto i = 0; i < numStates; ++i)
+        {
+            fallback.add (0);
+            firstMatchAtState.add (-1);
+            nextMatchAtState.add (-1);
+        }
+
+        for (auto c = 0; c < stride; ++c)
+        {
+            auto& next = transitions[c];
+
+            if (next < 0)
+                next = 0;
+            else
+                queue.add (next);
+        }
+
+        for (auto head = 0; head < queue.getNumItems(); ++head)
+        {
+            auto state = queue[head];
+
+            // the matches at a state are its own pattern, followed by those of its fallback
+            nextMatchAtState[state] = firstMatchAtState[fallback[state]];
+            firstMatchAtState[state] = patternAtState[state] >= 0 ? state : nextMatchAtState[state];
+
+            for (auto c = 0; c < stride; ++c)
+            {
+                auto& next = transitions[state * stride + c];
+                auto fallbackNext = transitions[fallback[state] * stride + c];
+
+                if (next < 0)
+                {
+                    next = fallbackNext;
+                }
+                else
+                {
+                    fallback[next] = fallbackNext;
+                    queue.add (next);
+                }
+            }
+        }
+
+        // stores rows instead of states, so stepping needs no multiplication, with the lowest
+        // bit set for states where matches end, so finding none takes no extra lookup
+        for (auto& next : transitions)
+            next = (next << strideShift) | (firstMatchAtState[next] >= 0 ? hasMatchesFlag : 0);
+    }
+
+
+    static constexpr int hasMatchesFlag = 1;
+
+    std::uint16_t byteClasses[256];
+    int strideShift = 0;
+    int maxPatternLength = 0;
+
+    Array<int> transitions;
+    Array<int> patternAtState, firstMatchAtState, nextMatchAtState;
+    Array<int> patternLengths;
+};
+
+} // namespace hosa
@@ -0,0 +1,258 @@
+/*
+    Copyright (C)2020 Wouter Ensink
+
+    This file is part of the Hosa [Header Only String & Array] C++ Project
+        - see the github page to find out more: www.github.com/w-ensink/hosa
+
+    The code in this file is provided under the terms of the ISC license:
+    Permission to use, copy, modify, and/or distribute this software for any purpose with
+    or without fee is hereby granted, provided that the above copyright notice and this
+    permission notice appear in all copies.
+
+    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO
+    THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT
+    SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR
+    ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF
+    CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE
+    OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+#if __has_include (<charconv>)
+    #include <charconv>
+#endif
+
+namespace hosa::details
+{
+
+/** Turns numbers into text, without streams, locales or allocations.
+
+    All functions write into a buffer the caller provides, which has to be big enough for
+    the worst case (see maxCharsForIntegerType and maxCharsForDouble), and return the number of
+    chars written. No terminator is written.
+
+    Integers are written two digits at a time from a lookup table. Doubles are written as the
+    shortest text that reads back to exactly the same value, or with a fixed number of decimals
+    in fixed or scientific notation. That work is left to std::to_chars where the standard
+    library has it for floating point (which uses Ryu), with a printf based fallback otherwise.
+ */
+struct NumberFormatting final
+{
+    // "-9223372036854775808" is the longest, "0x" with 16 hex digits fits as well
+    static constexpr int maxCharsForInteger = 20;
+
+    // for 128 bit integers (where the compiler has them), "-170141183460469231731687303715884105728" is the longest
+    static constexpr int maxCharsForWideInteger = 40;
+
+    template <typename IntegerType>
+    static constexpr int maxCharsForIntegerType = sizeof (IntegerType) > 8 ? maxCharsForWideInteger : maxCharsForInteger;
+
+    // "-2.2250738585072014e-308" is the longest shortest representation
+    static constexpr int maxCharsForShortestDouble = 24;
+
+
+    template <typename IntegerType>
+    static int writeInteger (char* destination, IntegerType value, bool hexadecimal = false) noexcept
+    {
+        static_assert (std::is_integral_v<IntegerType>, "Only integer types can be written as integer");
+
+        // bool has no unsigned counterpart, it's written as 1 or 0 like an int would be
+        if constexpr (std::is_same_v<IntegerType, bool>)
+        {
+            return writeInteger (destination, static_cast<int> (value), hexadecimal);
+        }
+        else
+        {
+            using UnsignedType = std::make_unsigned_t<IntegerType>;
+            using WrittenType = std::conditional_t<(sizeof (IntegerType) > 8), UnsignedType, std::uint64_t>;
+
+            // like iostreams do, negative values are written as their two's complement in hex
+            if (hexadecimal)
+                return writeHexadecimal (destination, static_cast<WrittenType> (static_cast<UnsignedType> (value)));
+
+            if constexpr (std::is_signed_v<IntegerType>)
+            {
+                if (value < 0)
+                {
+                    *destination = '-';
+                    return 1 + writeUnsigned (destination + 1, UnsignedType (0) - static_cast<UnsignedType> (value));
+                }
+            }
+
+            return writeUnsigned (destination, static_cast<WrittenType> (value));
+        }
+    }
+
+
+    static int writeUnsigned (char* destination, std::uint64_t value) noexcept
+    {
+        static constexpr char digitPairs[] =
+            "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+            "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+            "8081828384858687888990919293949596979899";
+
+        auto numDigits = numDecimalDigits (value);
+        auto* position = destination + numDigits;
+
+        while (value >= 100)
+        {
+            auto pair = static_cast<std::size_t> (value % 100) * 2;
+            value /= 100;
+            *(--position) = digitPairs[pair + 1];
+            *(--position) = digitPairs[pair];
+        }
+
+        if (value >= 10)
+        {
+            auto pair = static_cast<std::size_t> (value) * 2;
+            *(--position) = digitPairs[pair + 1];
+            *(--position) = digitPairs[pair];
+        }
+        else
+        {
+            *(--position) = static_cast<char> ('0' + value);
+        }
+
+        return numDigits;
+    }
+
+
+    // 128 bit values are written 19 decimal digits at a time, the last of which fit in 64 bits
+    template <typename UnsignedType, std::enable_if_t<(sizeof (UnsignedType) > 8), int> = 0>
+    static int writeUnsigned (char* destination, UnsignedType value) noexcept
+    {
+        constexpr std::uint64_t nineteenDigits = 10000000000000000000ull;
+
+        if (value <= std::numeric_limits<std::uint64_t>::max())
+            return writeUnsigned (destination, static_cast<std::uint64_t> (value));
+
+        auto numDigits = writeUnsigned (destination, value / nineteenDigits);
+        auto lowDigits = static_cast<std::uint64_t> (value % nineteenDigits);
+
+        for (auto i = numDigits + 18; i >= numDigits; --i, lowDigits /= 10)
+            destination[i] = static_cast<char> ('0' + lowDigits % 10);
+
+        return numDigits + 19;
+    }
+
+
+    template <typename UnsignedType>
+    static int writeHexadecimal (char* destination, UnsignedType value) noexcept
+    {
+        static constexpr char hexDigits[] = "0123456789abcdef";
+        constexpr int maxNumDigits = 2 * (sizeof (UnsignedType) > 8 ? 16 : 8);
+
+        auto numDigits = 1;
+
+        while (numDigits < maxNumDigits && (value >> (4 * numDigits)) != 0)
+            ++numDigits;
+
+        destination[0] = '0';
+        destination[1] = 'x';
+
+        for (auto i = numDigits + 1; i >= 2; --i, value >>= 4)
+            destination[i] = hexDigits[value & 0xf];
+
+        return numDigits + 2;
+    }
+
+
+    static int numDecimalDigits (std::uint64_t value) noexcept
+    {
+        auto numDigits = 1;
+
+        for (;;)
+        {
+            if (value < 10)     return numDigits;
+            if (value < 100)    return numDigits + 1;
+            if (value < 1000)   return numDigits + 2;
+            if (value < 10000)  return numDigits + 3;
+
+            value /= 10000;
+            numDigits += 4;
+        }
+    }
+
+    //==============================================================================
+
+    /** The most chars writeDouble could need for the given arguments. */
+    static int maxCharsForDouble (double value, bool scientific = false, int decimals = 0) noexcept
+    {
+        if (decimals <= 0)
+            return maxCharsForShortestDouble;
+
+        if (scientific)
+            return 8 + decimals;
+
+        // sign, integer digits (up to 309 for the biggest doubles), point and decimals
+        return (std::fabs (value) < 1.0e16 ? 19 : 311) + decimals;
+    }
+
+
+    /** Writes the shortest text that reads back as the same double when decimals is 0,
+        otherwise writes the given number of decimals in fixed or scientific notation.
+     */
+    static int writeDouble (char* destination, double value, bool scientific = false, int decimals = 0) noexcept
+    {
+        auto* end = destination + maxCharsForDouble (value, scientific, decimals);
+
+       #if defined (__cpp_lib_to_chars)
+        auto result = decimals > 0 ? std::to_chars (destination, end, value, scientific ? std::chars_format::scientific
+                                                                                         : std::chars_format::fixed, decimals)
+                                   : (scientific ? std::to_chars (destination, end, value, std::chars_format::scientific)
+                                                 : std::to_chars (destination, end, value));
+
+        return static_cast<int> (result.ptr - destination);
+       #else
+        return writeDoubleWithPrintf (destination, end, value, scientific, decimals);
+       #endif
+    }
+
+private:
+
+    // snprintf always writes a terminator, so everything goes through a separate buffer
+    // first, to never write past the worst case length the caller made room for
+    static int writeDoubleWithPrintf (char* destination, char* end, double value, bool scientific, int decimals) noexcept
+    {
+        auto available = static_cast<std::size_t> (end - destination);
+
+        if (decimals > 0)
+        {
+            auto numChars = std::snprintf (nullptr, 0, scientific ? "%.*e" : "%.*f", decimals, value);
+            auto* buffer = static_cast<char*> (std::malloc ((std::size_t) numChars + 1));
+            std::snprintf (buffer, (std::size_t) numChars + 1, scientific ? "%.*e" : "%.*f", decimals, value);
+            numChars = numChars < (int) available ? numChars : (int) available;
+            memcpy (destination, buffer, (std::size_t) numChars);
+            std::free (buffer);
+            return numChars;
+        }
+
+        char buffer[32];
+        auto numChars = 0;
+
+        // try more and more significant digits, until the text reads back as the same value
+        for (auto precision = 1; precision <= 17; ++precision)
+        {
+            numChars = std::snprintf (buffer, sizeof (buffer), scientific ? "%.*e" : "%.*g",
+                                      scientific ? precision - 1 : precision, value);
+
+            if (std::strtod (buffer, nullptr) == value)
+                break;
+        }
+
+        memcpy (destination, buffer, (std::size_t) numChars);
+        return numChars;
+    }
+};
+
+} // namespace hosa::details
@@ -0,0 +1,451 @@
+/*
+    Copyright (C)2020 Wouter Ensink
+
+    This file is part of the Hosa [Header Only String & Array] C++ Project
+        - see the github page to find out more: www.github.com/w-ensink/hosa
+
+    The code in this file is provided under the terms of the ISC license:
+    Permission to use, copy, modify, and/or distribute this software for any purpose with
+    or without fee is hereby granted, provided that the above copyright notice and this
+    permission notice appear in all copies.
+
+    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO
+    THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT
+    SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR
+    ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF
+    CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE
+    OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+
+#pragma once
+
+#include <cerrno>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+#if __has_include (<charconv>)
+    #include <charconv>
+#endif
+
+namespace hosa
+{
+
+enum class ParseError
+{
+    none,
+    noDigits,       // the text doesn't start with a number (after white space)
+    outOfRange      // it does, but the number doesn't fit the requested type
+};
+
+
+/** What parsing a number from text gave: the value, whether that went well and how much of
+    the text was used. When the number was out of range, the value is clamped to the nearest
+    value the type can hold.
+ */
+template <typename NumberType>
+struct ParseResult final
+{
+    NumberType value {};
+    ParseError error = ParseError::none;
+    int numCharsConsumed = 0;
+
+    [[nodiscard]] explicit operator bool() const noexcept { return error == ParseError::none; }
+};
+
+
+namespace details
+{
+
+/** Reads numbers from text, without streams, locales or allocations.
+
+    Leading white space is skipped and a sign is allowed in front of any number (but a minus
+    in front of an unsigned one doesn't parse). Decimal integers are read 8 digits at a time
+    with a few integer multiplications (SWAR), hexadecimal ones may start with 0x.
+
+    Floating point numbers that have at most 19 significant digits and a small exponent can be
+    calculated exactly with a single multiplication or division (Clinger's fast path), which covers
+    most numbers found in practice. All others are left to std::from_chars, which implements
+    Eisel-Lemire, or strtod where the library doesn't have that for floating point.
+ */
+struct NumberParsing final
+{
+    template <typename NumberType>
+    static ParseResult<NumberType> parse (const char* text, int length, bool hexadecimal = false) noexcept
+    {
+        if constexpr (std::is_floating_point_v<NumberType>)
+            return parseFloatingPoint<NumberType> (text, length);
+        else
+            return parseInteger<NumberType> (text, length, hexadecimal);
+    }
+
+
+    template <typename IntegerType>
+    static ParseResult<IntegerType> parseInteger (const char* text, int length, bool hexadecimal = false) noexcept
+    {
+        static_assert (std::is_integral_v<IntegerType>, "Only integer types can be parsed as integer");
+
+        ParseResult<IntegerType> result;
+        auto position = skipWhiteSpace (text, length);
+        auto negative = false;
+
+        if (position < length && (text[position] == '-' || text[position] == '+'))
+            negative = text[position++] == '-';
+
+        if (negative && std::is_unsigned_v<IntegerType>)
+            return noDigits<IntegerType>();
+
+        if (hexadecimal && position + 2 < length && text[position] == '0'
+             && (text[position + 1] == 'x' || text[position + 1] == 'X') && hexDigitValue (text[position + 2]) >= 0)
+            position += 2;
+
+        auto digits = hexadecimal ? readHexDigits (text + position, length - position)
+                                  : readDecimalDigits (text + position, length - position);
+
+        if (digits.numChars == 0)
+            return noDigits<IntegerType>();
+
+        result.numCharsConsumed = position + digits.numChars;
+
+        using Limits = std::numeric_limits<IntegerType>;
+        auto maxMagnitude = static_cast<std::uint64_t> (Limits::max()) + (negative ? 1u : 0u);
+
+        if (digits.overflowed || digits.value > maxMagnitude)
+        {
+            result.error = ParseError::outOfRange;
+            result.value = negative ? Limits::min() : Limits::max();
+            return result;
+        }
+
+        result.value = negative ? static_cast<IntegerType> (0u - digits.value) : static_cast<IntegerType> (digits.value);
+        return result;
+    }
+
+
+    template <typename FloatType>
+    static ParseResult<FloatType> parseFloatingPoint (const char* text, int length) noexcept
+    {
+        static_assert (std::is_floating_point_v<FloatType>, "Only floating point types can be parsed as such");
+
+        ParseResult<FloatType> result;
+        auto start = skipWhiteSpace (text, length);
+        auto number = scanDecimal (text + start, length - start);
+
+        if (number.numChars == 0 && ! startsWithLetter (text + start + number.signLength, length - start - number.signLength))
+            return noDigits<FloatType>();
+
+        constexpr auto maxExactMantissa = std::uint64_t (1) << std::numeric_limits<FloatType>::digits;
+        constexpr auto maxExactExponent = std::is_same_v<FloatType, float> ? 10 : 22;
+
+        if (number.numChars > 0 && ! number.tooManyDigits && number.mantissa <= maxExactMantissa
+             && number.exponent >= -maxExactExponent && number.exponent <= maxExactExponent)
+        {
+            auto value = static_cast<FloatType> (number.mantissa);
+            auto power = static_cast<FloatType> (powerOfTen (number.exponent < 0 ? -number.exponent : number.exponent));
+            value = number.exponent < 0 ? value / power : value * power;
+
+            result.value = number.negative ? -value : value;
+            result.numCharsConsumed = start + number.numChars;
+            return result;
+        }
+
+        return parseFloatingPointSlowly<FloatType> (text, length, start, number);
+    }
+
+private:
+
+    struct Digits
+    {
+        std::uint64_t value = 0;
+        int numChars = 0;
+        bool overflowed = false;
+    };
+
+
+    struct DecimalNumber
+    {
+        std::uint64_t mantissa = 0;
+        int exponent = 0;
+        int numChars = 0;
+        int signLength = 0;
+        bool negative = false;
+        bool tooManyDigits = false;
+    };
+
+
+    template <typename NumberType>
+    static ParseResult<NumberType> noDigits() noexcept
+    {
+        return { NumberType(), ParseError::noDigits, 0 };
+    }
+
+
+    static int skipWhiteSpace (const char* text, int length) noexcept
+    {
+        auto position = 0;
+
+        while (position < length && (text[position] == ' ' || (text[position] >= 9 && text[position] <= 13)))
+            ++position;
+
+        return position;
+    }
+
+
+    static bool isDigit (char c) noexcept
+    {
+        return static_cast<unsigned char> (c - '0') < 10;
+    }
+
+
+    static int hexDigitValue (char c) noexcept
+    {
+        if (isDigit (c))           return c - '0';
+        if (c >= 'a' && c <= 'f')  return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F')  return c - 'A' + 10;
+        return -1;
+    }
+
+
+    static bool startsWithLetter (const char* text, int length) noexcept
+    {
+        return length > 0 && ((text[0] | 0x20) == 'i' || (text[0] | 0x20) == 'n');
+    }
+
+
+    static double powerOfTen (int exponent) noexcept
+    {
+        static constexpr double powers[] = { 1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+                                             1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+        return powers[exponent];
+    }
+
+
+    // checks 8 chars at once: a digit has 3 as its high nibble, and stays below 0x40 after adding 6
+    static bool areEightDigits (std::uint64_t chars) noexcept
+    {
+        return ((chars & 0xf0f0f0f0f0f0f0f0ull)
+                 | (((chars + 0x0606060606060606ull) & 0xf0f0f0f0f0f0f0f0ull) >> 4)) == 0x3333333333333333ull;
+    }
+
+
+    // combines 8 digits in little endian order into their value, by first combining pairs,
+    // then pairs of pairs and then the two halves
+    static std::uint32_t parseEightDigits (std::uint64_t chars) noexcept
+    {
+        chars -= 0x3030303030303030ull;
+        chars = (chars * 10) + (chars >> 8);
+        chars = (((chars & 0x000000ff000000ffull) * (100 + (1000000ull << 32)))
+                  + (((chars >> 16) & 0x000000ff000000ffull) * (1 + (10000ull << 32)))) >> 32;
+        return static_cast<std::uint32_t> (chars);
+    }
+
+
+    static bool canReadEightDigitsAtOnce() noexcept
+    {
+       #if defined (__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+        return true;
+       #elif defined (_M_X64) || defined (_M_IX86) || defined (_M_ARM64)
+        return true;
+       #else
+        return false;
+       #endif
+    }
+
+
+    static Digits readDecimalDigits (const char* text, int length) noexcept
+    {
+        constexpr auto maxValue = std::numeric_limits<std::uint64_t>::max();
+        Digits digits;
+
+        if (canReadEightDigitsAtOnce())
+        {
+            while (digits.numChars + 8 <= length)
+            {
+                std::uint64_t chars;
+                memcpy (&chars, text + digits.numChars, sizeof (chars));
+
+                if (! areEightDigits (chars))
+                    break;
+
+                auto block = parseEightDigits (chars);
+
+                if (digits.value > (maxValue - block) / 100000000u)
+                    digits.overflowed = true;
+
+                digits.value = digits.value * 100000000u + block;
+                digits.numChars += 8;
+            }
+        }
+
+        for (; digits.numChars < length && isDigit (text[digits.numChars]); ++digits.numChars)
+        {
+            auto digit = static_cast<std::uint64_t> (text[digits.numChars] - '0');
+
+            if (digits.value > (maxValue - digit) / 10)
+                digits.overflowed = true;
+
+            digits.value = digits.value * 10 + digit;
+        }
+
+        return digits;
+    }
+
+
+    static Digits readHexDigits (const char* text, int length) noexcept
+    {
+        Digits digits;
+
+        for (; digits.numChars < length; ++digits.numChars)
+        {
+            auto digit = hexDigitValue (text[digits.numChars]);
+
+            if (digit < 0)
+                break;
+
+            if ((digits.value >> 60) != 0)
+                digits.overflowed = true;
+
+            digits.value = (digits.value << 4) | static_cast<std::uint64_t> (digit);
+        }
+
+        return digits;
+    }
+
+
+    // reads sign, digits, decimal point and exponent, keeping up to 19 significant digits,
+    // numChars stays 0 when there are no digits at all
+    static DecimalNumber scanDecimal (const char* text, int length) noexcept
+    {
+        DecimalNumber number;
+        auto position = 0;
+
+        if (position < length && (text[position] == '-' || text[position] == '+'))
+        {
+            number.negative = text[position++] == '-';
+            number.signLength = 1;
+        }
+
+        auto numSignificantDigits = 0;
+        auto numDigits = 0;
+
+        auto readDigits = [&] (bool isFraction)
+        {
+            for (; position < length && isDigit (text[position]); ++position, ++numDigits)
+            {
+                if (numSignificantDigits == 0 && text[position] == '0')
+                {
+                    number.exponent -= isFraction ? 1 : 0;
+                    continue;
+                }
+
+                if (numSignificantDigits < 19)
+                {
+                    number.mantissa = number.mantissa * 10 + static_cast<std::uint64_t> (text[position] - '0');
+                    number.exponent -= isFraction ? 1 : 0;
+                    ++numSignificantDigits;
+                }
+                else
+                {
+                    number.tooManyDigits = true;
+                    number.exponent += isFraction ? 0 : 1;
+                }
+            }
+        };
+
+        readDigits (false);
+
+        if (position < length && text[position] == '.')
+        {
+            ++position;
+            readDigits (true);
+        }
+
+        if (numDigits == 0)
+            return number;
+
+        if (position + 1 < length && (text[position] == 'e' || text[position] == 'E'))
+        {
+            auto exponentStart = position + 1;
+            auto exponentIsNegative = false;
+
+            if (text[exponentStart] == '-' || text[exponentStart] == '+')
+                exponentIsNegative = text[exponentStart++] == '-';
+
+            if (exponentStart < length && isDigit (text[exponentStart]))
+            {
+                auto exponent = 0;
+
+                for (position = exponentStart; position < length && isDigit (text[position]); ++position)
+                    if (exponent < 100000)
+                        exponent = exponent * 10 + (text[position] - '0');
+
+                number.exponent += exponentIsNegative ? -exponent : exponent;
+            }
+        }
+
+        number.numChars = position;
+        return number;
+    }
+
+
+    template <typename FloatType>
+    static ParseResult<FloatType> parseFloatingPointSlowly (const char* text, int length, int start,
+                                                            const DecimalNumber& number) noexcept
+    {
+        ParseResult<FloatType> result;
+
+        // from_chars doesn't accept a plus sign, the sign is applied afterwards anyway
+        auto* first = text + start + number.signLength;
+        auto* last = text + length;
+
+       #if defined (__cpp_lib_to_chars)
+        auto converted = std::from_chars (first, last, result.value);
+
+        if (converted.ec == std::errc::invalid_argument)
+            return noDigits<FloatType>();
+
+        if (converted.ec == std::errc::result_out_of_range)
+        {
+            result.error = ParseError::outOfRange;
+            result.value = number.exponent < 0 ? FloatType (0) : std::numeric_limits<FloatType>::infinity();
+        }
+
+        auto numChars = static_cast<int> (converted.ptr - first);
+       #else
+        // strtod needs a terminated string and reads hex floats, so it only gets the part that was scanned
+        auto numToCopy = number.numChars > 0 ? number.numChars - number.signLength : static_cast<int> (last - first);
+        auto* copy = static_cast<char*> (std::malloc ((std::size_t) numToCopy + 1));
+        memcpy (copy, first, (std::size_t) numToCopy);
+        copy[numToCopy] = '\0';
+
+        char* end = nullptr;
+        errno = 0;
+        auto parsed = std::strtod (copy, &end);
+        auto numChars = static_cast<int> (end - copy);
+        result.value = static_cast<FloatType> (parsed);
+
+        if (errno == ERANGE || (std::isfinite (parsed) && std::abs (parsed) > std::numeric_limits<FloatType>::max()))
+        {
+            result.error = ParseError::outOfRange;
+            result.value = number.exponent < 0 ? FloatType (0) : std::numeric_limits<FloatType>::infinity();
+        }
+
+        std::free (copy);
+
+        if (numChars == 0)
+            return noDigits<FloatType>();
+       #endif
+
+        result.value = number.negative ? -result.value : result.value;
+        result.numCharsConsumed = start + number.signLength + numChars;
+        return result;
+    }
+};
+
+} // namespace details
+
+} // namespace hosa
@@ -0,0 +1,500 @@
+/*
+    Copyright (C)2020 Wouter Ensink
+
+    This file is part of the Hosa [Header Only String & Array] C++ Project
+        - see the github page to find out more: www.github.com/w-ensink/hosa
+
+    The code in this file is provided under the terms of the ISC license:
+    Permission to use, copy, modify, and/or distribute this software for any purpose with
+    or without fee is hereby granted, provided that the above copyright notice and this
+    permission notice appear in all copies.
+
+    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO
+    THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT
+    SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR
+    ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF
+    CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE
+    OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+
+#pragma once
+
+#include <memory>
+#include <ostream>
+#include <utility>
+#include "hosa_String.h"
+
+namespace hosa
+{
+
+/** Text for editing large documents: inserting, removing and replacing take O(log n)
+    instead of copying the whole text like String does.
+
+    The text is kept as a balanced (AVL) tree of chunks. Nodes are never changed once made, so
+    an edit only creates the O(log n) nodes on the path to the edit, and shares all others with
+    the Rope it was made from. That also makes copying a Rope O(1), and copies safe to read from
+    other threads. Chunks are views into shared Strings, so splitting a chunk never copies text.
+
+    @code
+    auto document = Rope (loadedText);
+    document.insert ("<b>", 1000).insert ("</b>", 2000).replaceAll ("colour", "color");
+    document.forEachChunk ([&] (StringView chunk) { output.write (chunk); });
+    @endcode
+ */
+class Rope final
+{
+public:
+
+    Rope() = default;
+
+    /** Takes over the String's buffer, so this doesn't copy the text. */
+    explicit Rope (String text)
+        : root (buildFromStorage (std::make_shared<const String> (std::move (text))))
+    {
+    }
+
+    explicit Rope (StringView text)
+        : Rope (String (text))
+    {
+    }
+
+    //==============================================================================
+
+    [[nodiscard]] int length() const noexcept { return lengthOf (root); }
+    [[nodiscard]] bool isEmpty() const noexcept { return root == nullptr; }
+
+    /** Character indexing in O(log n), negative index returns index starting from the back. */
+    char operator[] (int index) const noexcept
+    {
+        index = index < 0 ? length() + index : index;
+        auto* node = root.get();
+
+        while (! node->isLeaf())
+        {
+            if (index < node->left->length)
+            {
+                node = node->left.get();
+            }
+            else
+            {
+                index -= node->left->length;
+                node = node->right.get();
+            }
+        }
+
+        return node->text[index];
+    }
+
+    /** Calls the function with a StringView of each chunk of text, in order. */
+    template <typename Function>
+    void forEachChunk (Function&& function) const
+    {
+        forEachChunk (root.get(), function);
+    }
+
+    /** Copies all text into a String, with a single allocation. */
+    [[nodiscard]] String toString() const
+    {
+        auto builder = StringBuilder (length());
+        forEachChunk ([&builder] (StringView chunk) { builder.append (chunk); });
+        return builder.release();
+    }
+
+    //==============================================================================
+
+    /** Puts given text at the end of this Rope. */
+    Rope& append (StringView text)       { return append (Rope (text)); }
+    Rope& append (const Rope& other)     { root = join (root, other.root); return *this; }
+
+    /** Puts given text before this Rope. */
+    Rope& prepend (StringView text)      { return prepend (Rope (text)); }
+    Rope& prepend (const Rope& other)    { root = join (other.root, root); return *this; }
+
+    /** Inserts given text into this Rope at the specified position. */
+    Rope& insert (StringView text, int index) { return insert (Rope (text), index); }
+
+    Rope& insert (const Rope& other, int index)
+    {
+        auto parts = split (root, clipIndex (index));
+        root = join (join (parts.first, other.root), parts.second);
+        return *this;
+    }
+
+    /** Removes given number of chars from this Rope, starting from specified index. */
+    Rope& remove (int startIndex, int numChars)
+    {
+        startIndex = clipIndex (startIndex);
+        auto end = clipIndex (startIndex + (numChars < 0 ? 0 : numChars));
+        auto tail = split (root, end).second;
+        root = join (split (root, startIndex).first, tail);
+        return *this;
+    }
+
+    /** Removes the first occurrence of the given text from this Rope. */
+    Rope& remove (StringView toRemove)
+    {
+        auto index = indexOfSubString (toRemove);
+        return index < 0 ? *this : remove (index, toRemove.length());
+    }
+
+    /** Replaces the first occurrence of the given text with another text. */
+    Rope& replace (StringView toReplace, StringView replaceWith)
+    {
+        auto index = indexOfSubString (toReplace);
+
+        if (index >= 0)
+            replaceRange (index, toReplace.length(), Rope (replaceWith).root);
+
+        return *this;
+    }
+
+    /** Replaces every occurrence of the given text with another text. */
+    Rope& replaceAll (StringView toReplace, StringView replaceWith)
+    {
+        if (toReplace.isEmpty())
+            return *this;
+
+        auto replacement = Rope (replaceWith).root;
+
+        for (auto index = indexOfSubString (toReplace); index >= 0;
+             index = indexOfSubString (toReplace, index + replaceWith.length()))
+            replaceRange (index, toReplace.length(), replacement);
+
+        return *this;
+    }
+
+    /** Swaps the first occurrences of the two specified texts, if both are found and don't overlap. */
+    Rope& swap (StringView one, StringView two)
+    {
+        auto firstIndex = indexOfSubString (one);
+        auto secondIndex = indexOfSubString (two);
+
+        if (firstIndex < 0 || secondIndex < 0)
+            return *this;
+
+        if (secondIndex < firstIndex)
+        {
+            std::swap (firstIndex, secondIndex);
+            std::swap (one, two);
+        }
+
+        if (firstIndex + one.length() > secondIndex)
+            return *this;
+
+        auto [head, rest] = split (root, firstIndex);
+        auto [middle, tail] = split (rest, secondIndex - firstIndex);
+        auto [first, between] = split (middle, one.length());
+        auto second = split (tail, two.length());
+
+        root = join (join (join (head, second.first), join (between, first)), second.second);
+        return *this;
+    }
+
+    /** Returns the specified part of this Rope, sharing its chunks. */
+    [[nodiscard]] Rope substring (int startIndex, int numChars) const
+    {
+        startIndex = clipIndex (startIndex);
+        auto result = Rope();
+        result.root = split (split (root, startIndex).second, numChars < 0 ? 0 : numChars).first;
+        return result;
+    }
+
+    //==============================================================================
+
+    /** Returns index at which the given substring starts within this Rope, or -1 if it isn't in there.
+        The search starts at the given index, the returned index is counted from the start of the Rope.
+     */
+    [[nodiscard]] int indexOfSubString (StringView toFind, int startFrom = 0) const
+    {
+        if (startFrom < 0 || startFrom > length())
+            return -1;
+
+        if (toFind.isEmpty())
+            return startFrom;
+
+        auto result = -1;
+
+        // the last chars before each chunk, to find matches that start in one chunk and end in the next
+        auto carry = String();
+        auto maxCarry = toFind.length() - 1;
+
+        forEachChunkUntil (root.get(), 0, startFrom, [&] (int chunkStart, StringView chunk)
+        {
+            if (carry.length() > 0)
+            {
+                auto window = String (carry);
+                window.append (chunk.substring (0, maxCarry));
+                auto windowStart = chunkStart - carry.length();
+                auto index = window.view().indexOfSubString (toFind, startFrom > windowStart ? startFrom - windowStart : 0);
+
+                if (index >= 0 && index < carry.length())
+                {
+                    result = windowStart + index;
+                    return true;
+                }
+            }
+
+            auto index = chunk.indexOfSubString (toFind, startFrom > chunkStart ? startFrom - chunkStart : 0);
+
+            if (index >= 0)
+            {
+                result = chunkStart + index;
+                return true;
+            }
+
+            carry.append (chunk.substring (chunk.length() - maxCarry, maxCarry));
+
+            if (carry.length() > maxCarry)
+                carry = String (carry.substringView (carry.length() - maxCarry, maxCarry));
+
+            return false;
+        });
+
+        return result;
+    }
+
+    [[nodiscard]] bool contains (StringView toFind) const { return indexOfSubString (toFind) >= 0; }
+
+    [[nodiscard]] bool equals (StringView other) const
+    {
+        if (other.length() != length())
+            return false;
+
+        auto equal = true;
+
+        forEachChunkUntil (root.get(), 0, 0, [&] (int chunkStart, StringView chunk)
+        {
+            equal = other.substring (chunkStart, chunk.length()) == chunk;
+            return ! equal;
+        });
+
+        return equal;
+    }
+
+    friend bool operator== (const Rope& lhs, StringView rhs) { return   lhs.equals (rhs); }
+    friend bool operator!= (const Rope& lhs, StringView rhs) { return ! lhs.equals (rhs); }
+
+    /** The number of chunks the text is spread over. */
+    [[nodiscard]] int getNumChunks() const noexcept
+    {
+        auto num = 0;
+        forEachChunk ([&num] (StringView) { ++num; });
+        return num;
+    }
+
+    /** The height of the tree, which stays within about 1.44 log2 of the number of chunks. */
+    [[nodiscard]] int getHeight() const noexcept { return heightOf (root); }
+
+    /** Prints this Rope to the standard console, handy for debugging or experimentation for example. */
+    void print() const { toString().print(); }
+
+private:
+
+    struct Node;
+    using NodePointer = std::shared_ptr<const Node>;
+
+    struct Node
+    {
+        // only set for inner nodes
+        NodePointer left, right;
+
+        // only set for leaves: the chars, and the String that owns them
+        std::shared_ptr<const String> storage;
+        StringView text;
+
+        int length = 0;
+        int height = 0;
+
+        [[nodiscard]] bool isLeaf() const noexcept { return left == nullptr; }
+    };
+
+
+    // texts are cut into chunks of this size, and neighbouring chunks shorter than
+    // mergeLength together are combined, so many small edits don't leave many tiny chunks
+    static constexpr int chunkLength = 1024;
+    static constexpr int mergeLength = 128;
+
+    NodePointer root;
+
+
+    static int lengthOf (const NodePointer& node) noexcept { return node == nullptr ? 0 : node->length; }
+    static int heightOf (const NodePointer& node) noexcept { return node == nullptr ? 0 : node->height; }
+
+    int clipIndex (int index) const noexcept
+    {
+        return index < 0 ? 0 : (index > length() ? length() : index);
+    }
+
+
+    static NodePointer makeLeaf (std::shared_ptr<const String> storage, StringView text)
+    {
+        if (text.isEmpty())
+            return nullptr;
+
+        auto leaf = std::make_shared<Node>();
+        leaf->storage = std::move (storage);
+        leaf->text = text;
+        leaf->length = text.length();
+        return leaf;
+    }
+
+
+    static NodePointer makeNode (NodePointer left, NodePointer right)
+    {
+        auto node = std::make_shared<Node>();
+        node->length = left->length + right->length;
+        node->height = 1 + std::max (left->height, right->height);
+        node->left = std::move (left);
+        node->right = std::move (right);
+        return node;
+    }
+
+
+    // builds a perfectly balanced tree of chunks that all point into the same storage
+    static NodePointer buildFromStorage (const std::shared_ptr<const String>& storage)
+    {
+        auto text = storage->view();
+        auto numChunks = (text.length() + chunkLength - 1) / chunkLength;
+        return buildFromStorage (storage, text, 0, numChunks);
+    }
+
+    static NodePointer buildFromStorage (const std::shared_ptr<const String>& storage, StringView text,
+                                         int firstChunk, int numChunks)
+    {
+        if (numChunks == 0)
+            return nullptr;
+
+        if (numChunks == 1)
+            return makeLeaf (storage, text.substring (firstChunk * chunkLength, chunkLength));
+
+        auto numLeft = numChunks / 2;
+        return makeNode (buildFromStorage (storage, text, firstChunk, numLeft),
+                         buildFromStorage (storage, text, firstChunk + numLeft, numChunks - numLeft));
+    }
+
+
+    /** Concatenates two trees, rotating where needed to keep the result balanced. */
+    static NodePointer join (const NodePointer& left, const NodePointer& right)
+    {
+        if (left == nullptr)  return right;
+        if (right == nullptr) return left;
+
+        if (left->isLeaf() && right->isLeaf() && left->length + right->length <= mergeLength)
+        {
+            auto merged = String (left->text);
+            merged.append (right->text);
+            auto storage = std::make_shared<const String> (std::move (merged));
+            return makeLeaf (storage, storage->view());
+        }
+
+        if (left->height > right->height + 1)
+            return balance (left->left, join (left->right, right));
+
+        if (right->height > left->height + 1)
+            return balance (join (left, right->left), right->right);
+
+        return makeNode (left, right);
+    }
+
+
+    // combines two trees of which the heights differ by at most 2
+    static NodePointer balance (const NodePointer& left, const NodePointer& right)
+    {
+        if (heightOf (right) > heightOf (left) + 1)
+        {
+            if (heightOf (right->left) > heightOf (right->right))
+                return makeNode (makeNode (left, right->left->left), makeNode (right->left->right, right->right));
+
+            return makeNode (makeNode (left, right->left), right->right);
+        }
+
+        if (heightOf (left) > heightOf (right) + 1)
+        {
+            if (heightOf (left->right) > heightOf (left->left))
+                return makeNode (makeNode (left->left, left->right->left), makeNode (left->right->right, right));
+
+            return makeNode (left->left, makeNode (left->right, right));
+        }
+
+        return makeNode (left, right);
+    }
+
+
+    /** Splits a tree in the part before the index and the part from the index on. */
+    static std::pair<NodePointer, NodePointer> split (const NodePointer& node, int index)
+    {
+        if (node == nullptr || index <= 0)
+            return { nullptr, node };
+
+        if (index >= node->length)
+            return { node, nullptr };
+
+        if (node->isLeaf())
+            return { makeLeaf (node->storage, node->text.substring (0, index)),
+                     makeLeaf (node->storage, node->text.substring (index, node->length - index)) };
+
+        auto leftLength = node->left->length;
+
+        if (index == leftLength)
+            return { node->left, node->right };
+
+        if (index < leftLength)
+        {
+            auto parts = split (node->left, index);
+            return { parts.first, join (parts.second, node->right) };
+        }
+
+        auto parts = split (node->right, index - leftLength);
+        return { join (node->left, parts.first), parts.second };
+    }
+
+
+    void replaceRange (int startIndex, int numChars, const NodePointer& replacement)
+    {
+        auto tail = split (root, startIndex + numChars).second;
+        root = join (join (split (root, startIndex).first, replacement), tail);
+    }
+
+
+    template <typename Function>
+    static void forEachChunk (const Node* node, Function& function)
+    {
+        if (node == nullptr)
+            return;
+
+        if (node->isLeaf())
+        {
+            function (node->text);
+            return;
+        }
+
+        forEachChunk (node->left.get(), function);
+        forEachChunk (node->right.get(), function);
+    }
+
+    // like forEachChunk, but also passes where each chunk starts, skips the chunks that end
+    // before the given index, and stops as soon as the function returns true
+    template <typename Function>
+    static bool forEachChunkUntil (const Node* node, int nodeStart, int fromIndex, Function&& function)
+    {
+        if (node == nullptr || nodeStart + node->length <= fromIndex)
+            return false;
+
+        if (node->isLeaf())
+            return function (nodeStart, node->text);
+
+        return forEachChunkUntil (node->left.get(), nodeStart, fromIndex, function)
+            || forEachChunkUntil (node->right.get(), nodeStart + node->left->length, fromIndex, function);
+    }
+};
+
+
+template <typename Traits>
+std::basic_ostream<char, Traits>& operator<< (std::basic_ostream<char, Traits>& stream, const Rope& rope)
+{
+    rope.forEachChunk ([&stream] (StringView chunk) { stream << chunk; });
+    return stream;
+}
+
+} // namespace hosa
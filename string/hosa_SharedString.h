@@ -0,0 +1,273 @@
+/*
+    Copyright (C)2020 Wouter Ensink
+
+    This file is part of the Hosa [Header Only String & Array] C++ Project
+        - see the github page to find out more: www.github.com/w-ensink/hosa
+
+    The code in this file is provided under the terms of the ISC license:
+    Permission to use, copy, modify, and/or distribute this software for any purpose with
+    or without fee is hereby granted, provided that the above copyright notice and this
+    permission notice appear in all copies.
+
+    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO
+    THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT
+    SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR
+    ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF
+    CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE
+    OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <new>
+#include <ostream>
+#include <utility>
+#include "hosa_String.h"
+
+namespace hosa
+{
+
+/** Text that is mostly copied around and rarely changed, like names in config or routing tables.
+
+    Copies share a single buffer with an atomic reference count, so copying costs an increment
+    instead of an allocation, also when a whole Array<SharedString> gets copied. The text is only
+    copied when it's changed while other copies are still sharing it (copy on write).
+    Different SharedStrings can be used from different threads, even if they share their text.
+ */
+class SharedString final
+{
+public:
+
+    SharedString() noexcept = default;
+
+    explicit SharedString (StringView text)
+    {
+        if (! text.isEmpty())
+        {
+            block = createBlock (text.length());
+            appendToUniqueBlock (text);
+        }
+    }
+
+    explicit SharedString (const String& text)
+        : SharedString (text.view())
+    {
+    }
+
+    SharedString (const SharedString& other) noexcept
+        : block (other.block)
+    {
+        if (block != nullptr)
+            block->refCount.fetch_add (1, std::memory_order_relaxed);
+    }
+
+    SharedString (SharedString&& other) noexcept
+        : block (std::exchange (other.block, nullptr))
+    {
+    }
+
+    SharedString& operator= (const SharedString& other) noexcept
+    {
+        auto copy = other;
+        std::swap (block, copy.block);
+        return *this;
+    }
+
+    SharedString& operator= (SharedString&& other) noexcept
+    {
+        std::swap (block, other.block);
+        return *this;
+    }
+
+    ~SharedString() { release (block); }
+
+    //==============================================================================
+
+    /** The null terminated text, which stays valid until this SharedString is changed or destroyed. */
+    [[nodiscard]] const char* toRawUTF8() const noexcept { return block == nullptr ? "" : block->chars(); }
+
+    [[nodiscard]] const char* data() const noexcept      { return toRawUTF8(); }
+    [[nodiscard]] int length() const noexcept            { return block == nullptr ? 0 : block->length; }
+    [[nodiscard]] bool isEmpty() const noexcept          { return length() == 0; }
+    [[nodiscard]] StringView view() const noexcept       { return { toRawUTF8(), length() }; }
+
+    operator StringView() const noexcept { return view(); }
+
+    /** Character indexing, negative index returns index starting from the back. */
+    char operator[] (int index) const noexcept { return view()[index]; }
+
+    [[nodiscard]] String toString() const { return String (view()); }
+
+    /** The same hash as StringView::hash() gives for the text. It's only computed once,
+        and then kept with the text, so all copies can use it.
+     */
+    [[nodiscard]] std::uint64_t hash() const noexcept
+    {
+        if (block == nullptr)
+            return view().hash();
+
+        auto result = block->cachedHash.load (std::memory_order_relaxed);
+
+        if (result == 0)
+        {
+            result = view().hash();
+            block->cachedHash.store (result, std::memory_order_relaxed);
+        }
+
+        return result;
+    }
+
+    /** True if other SharedStrings are using the same text at the moment. */
+    [[nodiscard]] bool isShared() const noexcept { return getReferenceCount() > 1; }
+
+    /** The number of SharedStrings that use this text, or 0 for an empty SharedString. */
+    [[nodiscard]] int getReferenceCount() const noexcept
+    {
+        return block == nullptr ? 0 : block->refCount.load (std::memory_order_acquire);
+    }
+
+    //==============================================================================
+
+    SharedString& operator= (StringView text) { return *this = SharedString (text); }
+
+    SharedString& append (StringView text)
+    {
+        if (! text.isEmpty())
+            makeUnique (length() + text.length(), text);
+
+        return *this;
+    }
+
+    SharedString& operator+= (StringView text) { return append (text); }
+
+    void clear() noexcept { release (std::exchange (block, nullptr)); }
+
+    /** Makes sure this SharedString is the only user of its text (by copying it if needed),
+        so the returned chars can be changed without affecting any of its copies.
+     */
+    [[nodiscard]] char* getWritableData()
+    {
+        if (block == nullptr)
+            return nullptr;
+
+        makeUnique (block->length);
+        block->cachedHash.store (0, std::memory_order_relaxed);
+        return block->chars();
+    }
+
+    //==============================================================================
+
+    friend bool operator== (const SharedString& lhs, const SharedString& rhs) noexcept
+    {
+        return lhs.block == rhs.block || lhs.view() == rhs.view();
+    }
+
+    friend bool operator!= (const SharedString& lhs, const SharedString& rhs) noexcept { return ! (lhs == rhs); }
+
+    friend bool operator== (const SharedString& lhs, StringView rhs) noexcept { return lhs.view() == rhs; }
+    friend bool operator== (StringView lhs, const SharedString& rhs) noexcept { return lhs == rhs.view(); }
+    friend bool operator!= (const SharedString& lhs, StringView rhs) noexcept { return lhs.view() != rhs; }
+    friend bool operator!= (StringView lhs, const SharedString& rhs) noexcept { return lhs != rhs.view(); }
+
+    friend bool operator<  (const SharedString& lhs, const SharedString& rhs) noexcept { return lhs.view() < rhs.view(); }
+
+    /** Prints this SharedString to the standard console, handy for debugging or experimentation for example. */
+    void print() const { view().print(); }
+
+private:
+
+    // the reference count and text live in one allocation: this header, directly followed by the chars
+    struct Block
+    {
+        std::atomic<int> refCount { 1 };
+        int length = 0;
+        int capacity = 0;
+
+        // 0 until the hash is asked for (and in the unlikely case the hash is 0)
+        std::atomic<std::uint64_t> cachedHash { 0 };
+
+        char* chars() noexcept { return reinterpret_cast<char*> (this + 1); }
+    };
+
+    Block* block = nullptr;
+
+
+    static Block* createBlock (int capacity)
+    {
+        auto* block = new (::operator new (sizeof (Block) + (std::size_t) capacity + 1)) Block();
+        block->capacity = capacity;
+        block->chars()[0] = '\0';
+        return block;
+    }
+
+    static void release (Block* block) noexcept
+    {
+        if (block != nullptr && block->refCount.fetch_sub (1, std::memory_order_acq_rel) == 1)
+        {
+            block->~Block();
+            ::operator delete (block);
+        }
+    }
+
+    // gives this SharedString a block of its own with room for the given number of chars, and appends
+    // the given text to it before letting go of the old block, because the text may be part of that
+    void makeUnique (int minCapacity, StringView toAppend = {})
+    {
+        if (block != nullptr && block->capacity >= minCapacity && getReferenceCount() == 1)
+        {
+            appendToUniqueBlock (toAppend);
+            return;
+        }
+
+        auto newCapacity = minCapacity;
+
+        if (block != nullptr && minCapacity > block->capacity)
+            newCapacity = static_cast<int> (((uint32_t) (minCapacity + minCapacity / 2 + 8)) & ~7u);
+
+        auto* newBlock = createBlock (newCapacity);
+
+        if (block != nullptr)
+        {
+            memcpy (newBlock->chars(), block->chars(), (std::size_t) block->length + 1);
+            newBlock->length = block->length;
+        }
+
+        auto* oldBlock = std::exchange (block, newBlock);
+        appendToUniqueBlock (toAppend);
+        release (oldBlock);
+    }
+
+    void appendToUniqueBlock (StringView text) noexcept
+    {
+        memcpy (block->chars() + block->length, text.data(), (std::size_t) text.length());
+        block->length += text.length();
+        block->cachedHash.store (0, std::memory_order_relaxed);
+        block->chars()[block->length] = '\0';
+    }
+};
+
+
+template <typename Traits>
+std::basic_ostream<char, Traits>& operator<< (std::basic_ostream<char, Traits>& stream, const SharedString& string)
+{
+    return stream << string.view();
+}
+
+} // namespace hosa
+
+
+namespace std
+{
+    template <>
+    struct hash<hosa::SharedString>
+    {
+        std::size_t operator() (const hosa::SharedString& string) const noexcept
+        {
+            return static_cast<std::size_t> (string.hash());
+        }
+    };
+}
@@ -20,32 +20,62 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <limits>
 #include <sstream>
 #include <string>
 #include "../array/hosa_Array.h"
+#include "../utility/hosa_MemoryResource.h"
 #include "hosa_StringHelpers.h"
+#include "hosa_StringTokenizer.h"
+#include "hosa_StringView.h"
 
 namespace hosa
 {
 
+template <char... Chars>
+class FormatString;
+
+class StringBuilder;
+
+namespace details
+{
+    template <typename Lhs, typename Rhs>
+    class Concatenation;
+}
+
+
 class String final
 {
 public:
     
-    String();
+    String() = default;
+    
+    /** An empty String that takes the memory for longer texts from the given resource, which has to outlive it.
+        The String keeps using that resource when it's assigned to, but copies of it use the heap.
+     */
+    explicit String (MemoryResource& resource) noexcept;
+    String (StringView text, MemoryResource& resource);
+    
     explicit String (const char* text);
-    String (const char* text, int length);
+    String (const char* text, int numChars);
     String (const String& other);
     String (String&& other) noexcept;
     explicit String (char character);
-    explicit String (int value, bool hexadecimal = false);
+    template <typename IntegerType, typename = IntegerNumberType<IntegerType>>
+    explicit String (IntegerType value, bool hexadecimal = false);
     explicit String (double value, bool useScientificNotation = false, int decimals = 0);
+    explicit String (StringView view);
     ~String();
     
     String& operator= (String&& other) noexcept ;
     String& operator= (const String& other);
     String& operator= (const char* other);
-    String& operator= (int value);
+    template <typename IntegerType, typename = IntegerNumberType<IntegerType>>
+    String& operator= (IntegerType value);
     String& operator= (double value);
     
     bool operator== (const String& other) const noexcept;
@@ -64,11 +94,14 @@ public:
     
     String& operator+= (const String& other);
     String& operator+= (const char* other);
-    String& operator+= (int value);
+    template <typename IntegerType, typename = IntegerNumberType<IntegerType>>
+    String& operator+= (IntegerType value);
     String& operator+= (double value);
     String& operator+= (char character);
+    String& operator+= (StringView view);
+    template <typename Lhs, typename Rhs>
+    String& operator+= (const details::Concatenation<Lhs, Rhs>& concatenation);
     
-    friend String operator+ (const String& lhs, const String& rhs);
     friend String operator- (const String& lhs, const String& rhs);
     friend String operator* (const String& lhs, int rhs);
     
@@ -80,6 +113,27 @@ public:
     explicit operator int()    const noexcept;
     explicit operator double() const noexcept;
     
+    /** Views are cheap to pass around, so a String can be handed to anything that takes one. */
+    operator StringView() const noexcept;
+    
+    /** Returns a view on all chars of this String, which is only valid as long as this String isn't changed. */
+    [[nodiscard]] StringView view() const noexcept;
+
+    /** A 64 bit hash of the text, the same as StringView::hash() gives for it. */
+    [[nodiscard]] std::uint64_t hash() const noexcept;
+    
+    /** True if the text is valid UTF-8. */
+    [[nodiscard]] bool isValidUTF8() const noexcept;
+
+    /** The number of codepoints in the text, where length() is the number of bytes. */
+    [[nodiscard]] int codepointLength() const noexcept;
+
+    /** The codepoints in the text as char32_t, for a range based for loop. Changing the String invalidates it. */
+    [[nodiscard]] CodepointRange codepoints() const noexcept;
+    
+    /** The resource texts that don't fit in the String itself are kept in, the default (heap) resource if it wasn't given one. */
+    [[nodiscard]] MemoryResource& getMemoryResource() const noexcept;
+    
     String& copyFrom (const char* string);
 
     [[nodiscard]] char* toRawUTF8() const noexcept;
@@ -94,11 +148,23 @@ public:
     
     
     /** Converts contained string to double,
-        only works if number is first element in the string
+        only works if number is first element in the string.
+        Both normal and scientific notation are always understood.
     */
     [[nodiscard]] double toDouble (bool scientificNotation = false) const;
+    
+    /** Parses the number at the start of this String (after any white space) as the given
+        integer or floating point type, telling whether that worked and how many chars it took.
+    */
+    template <typename NumberType>
+    [[nodiscard]] ParseResult<NumberType> parse (bool hexadecimal = false) const noexcept;
 
     [[nodiscard]] static String getDateAndTime();
+
+    /** Reads a whole file with a single read of its size, or returns an empty String if it can't be read.
+        Files of 2 GB or more don't fit in a String, those can be used through a MappedFile instead.
+    */
+    [[nodiscard]] static String loadFromFile (const char* path);
     
     /** Compares full string, case sensitive:
         If the tested string is smaller than this string, the answer is 1,
@@ -147,11 +213,19 @@ public:
     /** Checks whether this String contains the given String, without considiring case. */
     [[nodiscard]] bool containsIgnoreCase (const char* string) const noexcept;
     
-    /** Returns index at which the given substring starts within this String. */
+    /** Checks whether this String starts with the given String. */
+    [[nodiscard]] bool startsWith (StringView prefix) const noexcept;
+    
+    /** Checks whether this String ends with the given String. */
+    [[nodiscard]] bool endsWith (StringView suffix) const noexcept;
+    
+    /** Returns index at which the given substring starts within this String, or -1 if it isn't in there.
+        The search starts at the given index, the returned index is counted from the start of the String.
+     */
     [[nodiscard]] int indexOfSubString (const char* subString, int startFrom = 0) const noexcept;
     
-    /** Returns index at which the given substring starts within this String. */
-    [[nodiscard]] int indexOfSubString (const String& subString) const noexcept;
+    /** Returns index at which the given substring starts within this String, or -1 if it isn't in there. */
+    [[nodiscard]] int indexOfSubString (const String& subString, int startFrom = 0) const noexcept;
     
     /** Puts given character at the end of this String. */
     String& append (char character);
@@ -162,8 +236,16 @@ public:
     /** Puts given String at the end of this String. */
     String& append (const String& toAppend);
     
-    /** Puts given int value at the end of this String. */
-    String& append (int value, bool hexadecimal = false);
+    /** Puts the chars of the given view at the end of this String. */
+    String& append (StringView toAppend);
+    
+    /** Writes the result of a chain of operator+ straight into this String, growing it at most once. */
+    template <typename Lhs, typename Rhs>
+    String& append (const details::Concatenation<Lhs, Rhs>& concatenation);
+    
+    /** Puts given integer value at the end of this String. */
+    template <typename IntegerType, typename = IntegerNumberType<IntegerType>>
+    String& append (IntegerType value, bool hexadecimal = false);
     
     /** Puts given double value at the end of this String. */
     String& append (double value, bool scientific = false, int numDecimals = 0);
@@ -183,10 +265,10 @@ public:
     /** Returns a copy of this String but with the two specified substrings swapped. */
     [[nodiscard]] String swapped (const String& one, const String& two) const;
     
-    /** Reverses the order of all characters in this String. */
+    /** Reverses the order of all characters in this String, keeping multi byte UTF-8 chars intact. */
     String& reverse();
     
-    /** Returns a copy of this String, but with all the characters in reverse order. */
+    /** Returns a copy of this String, but with all the characters in reverse order (UTF-8 aware, like reverse()). */
     [[nodiscard]] String reversed() const;
     
     /** Replaces a specified part of this String with another String. */
@@ -198,22 +280,39 @@ public:
     /** Replaces a specified part of this String with an integer, if needed this int can be notated in the hex format. */
     String& replace (const String& toReplace, int value, bool hex = false);
     
+    /** Replaces every occurrence of a specified part of this String with another String.
+        Works in place when the replacement isn't longer than what it replaces,
+        otherwise the result is written into a single new allocation.
+     */
+    String& replaceAll (const char* toReplace, const char* replaceWith);
+    
+    /** Replaces every occurrence of a specified part of this String with another String. */
+    String& replaceAll (const String& toReplace, const String& replaceWith);
+    
+    /** Returns a copy of this String with every occurrence of a specified part replaced by another String. */
+    [[nodiscard]] String replacedAll (const String& toReplace, const String& replaceWith) const;
+    
     /** Returns a new String containing the specified part of this String. */
     [[nodiscard]] String substring (int startIndex, int numChars, bool clipOffWhiteSpace = false) const;
     
-    /** Python like format where each {} is replaced by the given arguments. */
-    template <typename FirstSub, typename... RestSubs>
-    String& format (FirstSub firstSub, RestSubs... restSubs);
+    /** Returns a view on the specified part of this String, without copying it. */
+    [[nodiscard]] StringView substringView (int startIndex, int numChars) const noexcept;
     
-    /** Python like format where each {} is replaced by the given arguments. */
-    template <typename Substitution>
-    String& format (Substitution substitution);
+    /** Returns a view on this String without the whitespace at its beginning and end. */
+    [[nodiscard]] StringView trimmedView() const noexcept;
+    
+    /** Python like format where each {} is replaced by the given arguments.
+        Arguments can be any mix of Strings, C strings, chars, integers and floating point numbers.
+        Arguments that don't have a {} left to go into are ignored.
+     */
+    template <typename... Arguments>
+    String& format (const Arguments&... arguments);
     
     /** Python like format where each {} is replaced by the given arguments.
         Leaves this String the same and returns a copied, formatted String.
      */
-    template <typename FirstSub, typename... RestSubs>
-    [[nodiscard]] String formatted (FirstSub firstSub, RestSubs... restSubs) const;
+    template <typename... Arguments>
+    [[nodiscard]] String formatted (const Arguments&... arguments) const;
     
     /** Returns a new copy of this String without the specified part. */
     [[nodiscard]] String without (const String& toRemove) const noexcept;
@@ -251,15 +350,30 @@ public:
     String& toLowerCase() noexcept;
     
     /** Returns a copy, but in all lower case, leaves this String unharmed. */
-    [[nodiscard]] String lowerCased() const;
+    [[nodiscard]] String lowerCased() const&;
+    
+    /** Lower cases the buffer of a String that's about to go away anyway, without allocating. */
+    [[nodiscard]] String lowerCased() &&;
     
     /** Returns a copy, but in all upper case, leaves this String unharmed. */
-    [[nodiscard]] String upperCased() const;
+    [[nodiscard]] String upperCased() const&;
+    
+    /** Upper cases the buffer of a String that's about to go away anyway, without allocating. */
+    [[nodiscard]] String upperCased() &&;
     
     /** Splits this String into an Array of Strings, separates at specified separator.
         Clips whitespace off by default.
      */
-    [[nodiscard]] Array<String> split (const String& splitAt, bool clipOffWhiteSpace = true) const;
+    [[nodiscard]] Array<String> split (StringView splitAt, bool clipOffWhiteSpace = true) const;
+    
+    /** Splits like split() does, but returns views into this String instead of copying every part. */
+    [[nodiscard]] Array<StringView> splitViews (StringView splitAt, bool clipOffWhiteSpace = true) const;
+    
+    /** Splits lazily: the parts are only looked for while iterating over the result, and are
+        handed out as views into this String, so nothing gets allocated. See StringTokenizer
+        for skipping empty parts and limiting the number of splits.
+     */
+    [[nodiscard]] StringTokenizer splitLazy (StringView splitAt, bool clipOffWhiteSpace = true) const noexcept;
     
     /** Converts an Array of Strings into one String, with a specified separator between the Array items. */
     static String joinFromArray (const Array<String>& array, const String& separator);
@@ -267,6 +381,12 @@ public:
     /** Gives the number of characters in the String. */
     [[nodiscard]] int length() const noexcept;
     
+    /** Gives the number of characters that fit in the String without it having to reallocate. */
+    [[nodiscard]] int getAllocatedSize() const noexcept;
+    
+    /** Makes sure the String can grow to the given number of characters without reallocating. */
+    void ensureAllocatedSpace (int minNumChars);
+    
     /** Prints this String to the standard console, handy for debugging or experimentation for example. */
     void print() const noexcept;
     
@@ -288,7 +408,60 @@ public:
     
 private:
     
-    char* text = nullptr;
+    template <char... Chars>
+    friend class FormatString;
+    
+    template <typename Lhs, typename Rhs>
+    friend class details::Concatenation;
+    
+    friend class StringBuilder;
+    
+    // Strings up to this size (terminator included) live inside the object itself,
+    // so short keys, chars and numbers never touch the heap
+    static constexpr int localBufferSize = 24;
+    
+    char* text = localBuffer;
+    MemoryResource* resource = nullptr;
+    int textLength = 0;
+    int allocatedSpace = localBufferSize - 1;
+    char localBuffer[localBufferSize] {};
+    
+    
+    /** Points text at a buffer that has room for the given number of chars and a terminator.
+        Only to be called on a String that doesn't own a heap buffer, the chars are left for
+        the caller to fill in.
+     */
+    char* preallocate (int numChars);
+    
+    /** Creates a String of the given length, for the caller to write the chars into. */
+    [[nodiscard]] static String withLength (int numChars, MemoryResource* resource = nullptr);
+    
+    String& appendNumChars (const char* string, int numChars);
+    
+    /** Appends the chars written by the given function, which gets a buffer of at least
+        maxNumChars to write into and returns how many chars it actually wrote.
+     */
+    template <typename WriteFunction>
+    String& appendWritten (int maxNumChars, WriteFunction&& write);
+    
+    String& assignNumChars (const char* string, int numChars);
+    
+    String& replaceNumChars (int index, int numCharsToRemove, const char* replaceWith, int replaceWithLength);
+    
+    String& replaceAllNumChars (const char* toReplace, int toReplaceLength, const char* replaceWith, int replaceWithLength);
+    
+    void setAllocatedSize (int newNumChars);
+    
+    [[nodiscard]] bool isUsingLocalBuffer() const noexcept;
+    
+    [[nodiscard]] bool pointsIntoBuffer (const char* string) const noexcept;
+    
+    void takeBufferFrom (String& other) noexcept;
+    
+    /** Allocates room for the given number of chars and a terminator, from the resource if there is one. */
+    [[nodiscard]] char* allocateChars (int numChars) const;
+    
+    void freeHeapBuffer() noexcept;
 };
 
 
@@ -296,9 +469,9 @@ private:
 
 namespace literals
 {
-    inline String operator "" _s (const char* text, unsigned long)
+    inline String operator "" _s (const char* text, unsigned long length)
     {
-        return String (text);
+        return String (text, (int) length);
     }
 }
 
@@ -316,73 +489,98 @@ std::basic_ostream<char, Traits>& operator<< (std::basic_ostream<char, Traits>&
 }
 
 
-String::String()
+String::String (MemoryResource& memoryResource) noexcept
+    : resource (&memoryResource)
 {
-    text = new char[1] {'\0'};
 }
 
 
-String::String (const char* text)
+String::String (StringView view, MemoryResource& memoryResource)
+    : resource (&memoryResource)
 {
-    copyFrom (text);
+    memcpy (preallocate (view.length()), view.data(), (std::size_t) view.length());
 }
 
 
-String::String (const char* text, int length)
+String::String (const char* string)
+    : String (string, details::StringHelpers::stringLength (string))
 {
-    moveFromString (details::StringHelpers::allocateAndCopyNumChars (text, length));
+}
+
+
+String::String (const char* string, int numChars)
+{
+    memcpy (preallocate (numChars), string, numChars * sizeof (char));
 }
 
 
 String::String (const String& other)
+    : String (other.text, other.textLength)
 {
-    copyFrom (other.text);
 }
 
 
-String::String (String&& other) noexcept : text (other.text)
+String::String (String&& other) noexcept
 {
-    other.text = nullptr;
+    takeBufferFrom (other);
 }
 
 
 String::String (char character)
 {
-    moveFromString (details::StringHelpers::charToString (character));
+    preallocate (1)[0] = character;
 }
 
 
-String::String (int value, bool hexadecimal)
+template <typename IntegerType, typename>
+String::String (IntegerType value, bool hexadecimal)
 {
-    moveFromString (details::StringHelpers::intToString (value, hexadecimal));
+    append (value, hexadecimal);
 }
 
 
 String::String (double value, bool useScientificNotation, int decimals)
 {
-    moveFromString (details::StringHelpers::doubleToString (value, useScientificNotation, decimals));
+    append (value, useScientificNotation, decimals);
+}
+
+
+String::String (StringView view)
+    : String (view.data(), view.length())
+{
 }
 
 
-String::~String() { delete[] text; }
+String::~String() { freeHeapBuffer(); }
 
 
 String& String::operator= (String&& other) noexcept
 {
-    text = other.text;
-    other.text = nullptr;
+    if (this == &other)
+        return *this;
+
+    // a String keeps its resource, so a buffer from another resource can't be taken over
+    if (resource != other.resource && ! other.isUsingLocalBuffer())
+        return assignNumChars (other.text, other.textLength);
+
+    freeHeapBuffer();
+    auto* ownResource = resource;
+    takeBufferFrom (other);
+    resource = ownResource;
     return *this;
 }
 
 
-String& String::operator= (const String& other) { return copyFrom (other.text); }
+String& String::operator= (const String& other) { return assignNumChars (other.text, other.textLength); }
 String& String::operator= (const char* other)   { return copyFrom (other);      }
-String& String::operator= (int value)    { return moveFromString (details::StringHelpers::intToString (value));    }
-String& String::operator= (double value) { return moveFromString (details::StringHelpers::doubleToString (value)); }
+String& String::operator= (double value) { return *this = String (value); }
+
+template <typename IntegerType, typename>
+String& String::operator= (IntegerType value) { return *this = String (value); }
 
 
-bool String::operator== (const String& other) const noexcept { return compare (other) == 0; }
-bool String::operator!= (const String& other) const noexcept { return compare (other) != 0; }
+bool String::operator== (const String& other) const noexcept { return   equals (other); }
+bool String::operator!= (const String& other) const noexcept { return ! equals (other); }
 bool String::operator>  (const String& other) const noexcept { return compare (other) >  0; }
 bool String::operator>= (const String& other) const noexcept { return compare (other) >= 0; }
 bool String::operator<  (const String& other) const noexcept { return compare (other) <  0; }
@@ -399,50 +597,72 @@ bool String::operator<= (const char* other) const noexcept { return compare (oth
 
 String& String::operator+= (const String& other) { return append (other);     }
 String& String::operator+= (const char* other)   { return append (other);     }
-String& String::operator+= (int value)           { return append (value);     }
 String& String::operator+= (double value)        { return append (value);     }
 String& String::operator+= (char character)      { return append (character); }
+String& String::operator+= (StringView view)      { return append (view);      }
+
+template <typename IntegerType, typename>
+String& String::operator+= (IntegerType value)   { return append (value);     }
 
 
-String operator+ (const String& lhs, const String& rhs)
+String operator- (const String& lhs, const String& rhs)
 {
-    return String (details::StringHelpers::buildStringFromPointers (lhs.text, rhs.text));
+    return lhs.without (rhs);
 }
 
 
-String operator- (const String& lhs, const String& rhs)
+String& String::operator-= (const String& other) { return remove (other); }
+String& String::operator-= (const char* other)   { return remove (other); }
+String& String::operator*= (int numTimes)        { return *this = (*this) * numTimes; }
+
+
+String::operator bool()   const noexcept { return textLength > 0; }
+String::operator int()    const noexcept { return toInt();      }
+String::operator double() const noexcept { return toDouble();   }
+
+
+String::operator StringView() const noexcept { return view(); }
+
+
+StringView String::view() const noexcept
 {
-    return lhs.without (rhs);
+    return { text, textLength };
 }
 
 
-String operator* (const String& lhs, int rhs)
+std::uint64_t String::hash() const noexcept
 {
-    if (rhs <= 0)
-        return ""_s;
+    return view().hash();
+}
+
 
-    auto result = lhs;
+bool String::isValidUTF8() const noexcept
+{
+    return details::UTF8::isValid (text, textLength);
+}
 
-    while (--rhs > 0)
-        result.append (lhs);
 
-    return result;
+int String::codepointLength() const noexcept
+{
+    return details::UTF8::countCodepoints (text, textLength);
 }
 
 
-String& String::operator-= (const String& other) { return remove (other); }
-String& String::operator-= (const char* other)   { return remove (other); }
-String& String::operator*= (int numTimes)        { return *this = (*this) * numTimes; }
+CodepointRange String::codepoints() const noexcept
+{
+    return { text, textLength };
+}
 
 
-String::operator bool()   const noexcept { return length() > 0; }
-String::operator int()    const noexcept { return toInt();      }
-String::operator double() const noexcept { return toDouble();   }
+MemoryResource& String::getMemoryResource() const noexcept
+{
+    return resource != nullptr ? *resource : getDefaultMemoryResource();
+}
 
 
 String& String::copyFrom (const char* string)
 {
-    return moveFromString (details::StringHelpers::allocateAndCopy (string));
+    return assignNumChars (string, details::StringHelpers::stringLength (string));
 }
 
 
@@ -454,19 +674,26 @@ char* String::toRawUTF8() const noexcept
 
 std::string String::toStdString() const
 {
-    return {details::StringHelpers::allocateAndCopy (text)};
+    return { text, (std::size_t) textLength };
 }
 
 
 int String::toInt (bool hexadecimal) const
 {
-    return details::StringHelpers::stringToInteger (text, hexadecimal);
+    return parse<int> (hexadecimal).value;
+}
+
+
+double String::toDouble (bool) const
+{
+    return parse<double>().value;
 }
 
 
-double String::toDouble (bool scientificNotation) const
+template <typename NumberType>
+ParseResult<NumberType> String::parse (bool hexadecimal) const noexcept
 {
-    return details::StringHelpers::stringToDouble (text, scientificNotation);
+    return details::NumberParsing::parse<NumberType> (text, textLength, hexadecimal);
 }
 
 
@@ -506,9 +733,35 @@ String String::getDateAndTime()
 }
 
 
+String String::loadFromFile (const char* path)
+{
+    auto* file = std::fopen (path, "rb");
+
+    if (file == nullptr)
+        return {};
+
+    auto result = String();
+
+    if (std::fseek (file, 0, SEEK_END) == 0)
+    {
+        auto size = std::ftell (file);
+
+        if (size > 0 && size < std::numeric_limits<int>::max() && std::fseek (file, 0, SEEK_SET) == 0)
+        {
+            auto* chars = result.preallocate ((int) size);
+            result.textLength = (int) std::fread (chars, 1, (std::size_t) size, file);
+            chars[result.textLength] = '\0';
+        }
+    }
+
+    std::fclose (file);
+    return result;
+}
+
+
 int String::compare (const String& string) const noexcept
 {
-    return compare (string.text);
+    return details::StringHelpers::compare (text, textLength, string.text, string.textLength);
 }
 
 
@@ -520,32 +773,32 @@ int String::compare (const char* string) const noexcept
 
 bool String::containsStartingAt (int index, const String& string) const noexcept
 {
-    auto len = details::StringHelpers::stringLength (string.text);
-    return details::StringHelpers::compareNumChars (text + index, string.text, len) == 0;
+    return index + string.textLength <= textLength
+        && details::StringHelpers::compareNumChars (text + index, string.text, string.textLength) == 0;
 }
 
 
 int String::compareIgnoreCase (const char* string) const noexcept
 {
-    return details::StringHelpers::fullStringCompareIgnoreCase (text, string);
+    return details::CaseConversion::compareIgnoreCase (text, textLength, string, details::StringHelpers::stringLength (string));
 }
 
 
 int String::compareIgnoreCase (const String& string) const noexcept
 {
-    return compareIgnoreCase (string.text);
+    return details::CaseConversion::compareIgnoreCase (text, textLength, string.text, string.textLength);
 }
 
 
 bool String::contains (const String& string) const noexcept
 {
-    return contains (string.text);
+    return details::StringSearch::contains (text, textLength, string.text, string.textLength);
 }
 
 
 bool String::contains (const char* string) const noexcept
 {
-    return details::StringHelpers::stringContains (text, string);
+    return details::StringSearch::contains (text, textLength, string, details::StringHelpers::stringLength (string));
 }
 
 
@@ -557,7 +810,7 @@ bool String::equals (const char* string) const noexcept
 
 bool String::equals (const String& string) const noexcept
 {
-    return compare (string) == 0;
+    return textLength == string.textLength && compare (string) == 0;
 }
 
 
@@ -569,61 +822,85 @@ bool String::equalsIgnoreCase (const char* string) const noexcept
 
 bool String::equalsIgnoreCase (const String& string) const noexcept
 {
-    return compareIgnoreCase (string) == 0;
+    return textLength == string.textLength
+        && details::CaseConversion::equalsIgnoreCase (text, string.text, textLength);
 }
 
 
 bool String::containsIgnoreCase (const String& string) const noexcept
 {
-    return containsIgnoreCase (string.text);
+    return details::CaseConversion::findIgnoreCase (text, textLength, string.text, string.textLength) >= 0;
 }
 
 
 bool String::containsIgnoreCase (const char* string) const noexcept
 {
-    return details::StringHelpers::containsIgnoreCase (text, string);
+    auto len = details::StringHelpers::stringLength (string);
+    return details::CaseConversion::findIgnoreCase (text, textLength, string, len) >= 0;
 }
 
 
+bool String::startsWith (StringView prefix) const noexcept { return view().startsWith (prefix); }
+bool String::endsWith (StringView suffix)   const noexcept { return view().endsWith (suffix);   }
+
+
 int String::indexOfSubString (const char* subString, int startFrom) const noexcept
 {
-    return details::StringHelpers::indexOfSubString (text + startFrom, subString);
+    auto index = details::StringSearch::find (text + startFrom, textLength - startFrom,
+                                              subString, details::StringHelpers::stringLength (subString));
+    return index < 0 ? index : index + startFrom;
 }
 
 
-int String::indexOfSubString (const String& subString) const noexcept
+int String::indexOfSubString (const String& subString, int startFrom) const noexcept
 {
-    return indexOfSubString (subString.text);
+    auto index = details::StringSearch::find (text + startFrom, textLength - startFrom,
+                                              subString.text, subString.textLength);
+    return index < 0 ? index : index + startFrom;
 }
 
 
 String& String::append (char character)
 {
-    return append (details::StringHelpers::charToString (character));
+    return appendNumChars (&character, 1);
 }
 
 
 String& String::append (const char* string)
 {
-    return moveFromString (details::StringHelpers::buildStringFromPointers (text, string));
+    return appendNumChars (string, details::StringHelpers::stringLength (string));
 }
 
 
 String& String::append (const String& toAppend)
 {
-    return append (toAppend.text);
+    return appendNumChars (toAppend.text, toAppend.textLength);
+}
+
+
+String& String::append (StringView toAppend)
+{
+    return appendNumChars (toAppend.data(), toAppend.length());
 }
 
 
-String& String::append (int value, bool hexadecimal)
+template <typename IntegerType, typename>
+String& String::append (IntegerType value, bool hexadecimal)
 {
-    return append (details::StringHelpers::intToString (value, hexadecimal));
+    return appendWritten (details::NumberFormatting::maxCharsForIntegerType<IntegerType>, [value, hexadecimal] (char* destination)
+    {
+        return details::NumberFormatting::writeInteger (destination, value, hexadecimal);
+    });
 }
 
 
 String& String::append (double value, bool scientific, int numDecimals)
 {
-    return append (details::StringHelpers::doubleToString (value, scientific, numDecimals));
+    return appendWritten (details::NumberFormatting::maxCharsForDouble (value, scientific, numDecimals),
+                          [value, scientific, numDecimals] (char* destination)
+    {
+        return details::NumberFormatting::writeDouble (destination, value, scientific, numDecimals);
+    });
 }
 
 
@@ -635,14 +912,22 @@ String& String::prepend (const String& string)
 
 String& String::prepend (const char* string)
 {
-    return moveFromString (details::StringHelpers::buildStringFromPointers (string, text));
+    return insert (string, 0);
 }
 
 
 String& String::swap (const char* one, const char* two)
 {
     if ((contains (one) && contains (two)) && details::StringHelpers::fullStringCompare (one, two) != 0)
-        return moveFromString (details::StringHelpers::swap (text, one, two));
+    {
+        auto result = withLength (textLength, resource);
+
+        details::StringHelpers::writeSwapped (result.text, text, textLength,
+                                              indexOfSubString (one), details::StringHelpers::stringLength (one),
+                                              indexOfSubString (two), details::StringHelpers::stringLength (two));
+
+        return *this = std::move (result);
+    }
 
     return *this;
 }
@@ -662,7 +947,8 @@ String String::swapped (const String& one, const String& two) const
 
 String& String::reverse()
 {
-    return moveFromString (details::StringHelpers::reverse (text));
+    details::UTF8::reverseCodepoints (text, textLength);
+    return *this;
 }
 
 
@@ -686,34 +972,63 @@ String& String::replace (const String& toReplace, int value, bool hexadecimal)
 
 String& String::replace (const char* toReplace, const char* replaceWith)
 {
-    if (contains (toReplace))
-        moveFromString (details::StringHelpers::replace (text, toReplace, replaceWith));
+    auto index = indexOfSubString (toReplace);
 
-    return *this;
+    if (index < 0)
+        return *this;
+
+    return replaceNumChars (index, details::StringHelpers::stringLength (toReplace),
+                            replaceWith, details::StringHelpers::stringLength (replaceWith));
+}
+
+
+String& String::replaceAll (const char* toReplace, const char* replaceWith)
+{
+    return replaceAllNumChars (toReplace, details::StringHelpers::stringLength (toReplace),
+                               replaceWith, details::StringHelpers::stringLength (replaceWith));
+}
+
+
+String& String::replaceAll (const String& toReplace, const String& replaceWith)
+{
+    return replaceAllNumChars (toReplace.text, toReplace.textLength, replaceWith.text, replaceWith.textLength);
+}
+
+
+String String::replacedAll (const String& toReplace, const String& replaceWith) const
+{
+    return String (*this).replaceAll (toReplace, replaceWith);
 }
 
 
 String String::substring (int startIndex, int numChars, bool clipOffWhiteSpace) const
 {
-    numChars = (startIndex + numChars >= length()) ? length() - startIndex : numChars;
-    auto result = String (details::StringHelpers::allocateAndCopyNumChars (text + startIndex, numChars));
+    auto part = substringView (startIndex, numChars);
+    return String (clipOffWhiteSpace ? part.trimmed() : part);
+}
+
 
-    return clipOffWhiteSpace ? result.clipOffWhiteSpace() : result;
+StringView String::substringView (int startIndex, int numChars) const noexcept
+{
+    return view().substring (startIndex, numChars);
 }
 
 
-String String::without (const String& toRemove) const noexcept
+StringView String::trimmedView() const noexcept
 {
-    if (contains (toRemove))
-        return String (details::StringHelpers::remove (text, toRemove.text));
+    return view().trimmed();
+}
 
-    return *this;
+
+String String::without (const String& toRemove) const noexcept
+{
+    return String (*this).remove (toRemove);
 }
 
 
 String String::withoutWhiteSpace() const noexcept
 {
-    return  String (details::StringHelpers::removeWhiteSpace (text));
+    return String (*this).removeWhiteSpace();
 }
 
 
@@ -725,7 +1040,10 @@ String& String::insert (const String& string, int index)
 
 String& String::insert (const char* string, int index)
 {
-    return moveFromString (details::StringHelpers::insert (text, string, index));
+    if (index > textLength || index < 0)
+        index = textLength;
+
+    return replaceNumChars (index, 0, string, details::StringHelpers::stringLength (string));
 }
 
 
@@ -737,8 +1055,10 @@ String& String::remove (const String& string)
 
 String& String::remove (const char* string)
 {
-    if (contains (string))
-        return moveFromString (details::StringHelpers::remove (text, string));
+    auto index = indexOfSubString (string);
+
+    if (index >= 0)
+        return remove (index, details::StringHelpers::stringLength (string));
 
     return *this;
 }
@@ -746,100 +1066,124 @@ String& String::remove (const char* string)
 
 String& String::remove (int startIndex, int numChars)
 {
-    moveFromString (details::StringHelpers::remove (text, startIndex, numChars));
-    return *this;
+    if (startIndex >= textLength)
+        return *this;
+
+    numChars = startIndex + numChars >= textLength ? textLength - startIndex : numChars;
+
+    return replaceNumChars (startIndex, numChars, "", 0);
 }
 
 
 String& String::removeWhiteSpace()
 {
-    return moveFromString (details::StringHelpers::removeWhiteSpace (text));
+    // compacting in place is safe, the write position never passes the read position
+    auto newLength = details::StringHelpers::stringLengthIgnoreWhiteSpace (text);
+    details::StringHelpers::writeWithoutWhiteSpace (text, text, textLength);
+
+    textLength = newLength;
+    text[textLength] = '\0';
+    return *this;
 }
 
 
 String& String::clipOffWhiteSpace()
 {
-    return moveFromString (details::StringHelpers::clipOffWhiteSpace (text));
+    auto numLeading = details::StringHelpers::numLeadingWhiteSpace (text, textLength);
+    auto numTrailing = details::StringHelpers::numTrailingWhiteSpace (text + numLeading, textLength - numLeading);
+
+    textLength -= numLeading + numTrailing;
+    memmove (text, text + numLeading, textLength * sizeof (char));
+    text[textLength] = '\0';
+    return *this;
 }
 
 
 String& String::toUpperCase() noexcept
 {
-    details::StringHelpers::toUpperCase (text);
+    details::CaseConversion::writeUpperCased (text, text, textLength);
     return *this;
 }
 
 
 String& String::toLowerCase() noexcept
 {
-    details::StringHelpers::toLowerCase (text);
+    details::CaseConversion::writeLowerCased (text, text, textLength);
     return *this;
 }
 
 
-String String::lowerCased() const
+String String::lowerCased() const&
 {
-    return String (details::StringHelpers::lowerCased (text));
+    auto result = withLength (textLength);
+    details::CaseConversion::writeLowerCased (result.text, text, textLength);
+    return result;
+}
+
+
+String String::lowerCased() &&
+{
+    return std::move (toLowerCase());
 }
 
 
-String String::upperCased() const
+String String::upperCased() const&
 {
-    return String (details::StringHelpers::upperCased (text));
+    auto result = withLength (textLength);
+    details::CaseConversion::writeUpperCased (result.text, text, textLength);
+    return result;
 }
 
 
-Array<String> String::split (const String& splitAt, bool clipOffWhiteSpace) const
+String String::upperCased() &&
 {
-    if (! contains (splitAt))
-        return {*this};
+    return std::move (toUpperCase());
+}
+
 
-    auto index = 0;
-    auto len = length();
-    auto lenToFind = splitAt.length();
+Array<String> String::split (StringView splitAt, bool clipOffWhiteSpace) const
+{
     auto result = Array<String>();
-    auto lastIndex = 0;
 
-    while (index + lenToFind <= len)
-    {
-        if (containsStartingAt (index, splitAt))
-        {
-            result.add (substring (lastIndex, index - lastIndex, clipOffWhiteSpace));
-            index += lenToFind;
-            lastIndex = index;
-        }
-        else
-        {
-            ++index;
-        }
-    }
+    for (auto part : splitLazy (splitAt, clipOffWhiteSpace))
+        result.add (String (part));
 
-    result.add (substring (lastIndex, len, clipOffWhiteSpace));
+    // a String without the separator in it is returned as it is, untrimmed
+    if (result.getNumItems() == 1)
+        result[0] = *this;
 
     return result;
 }
 
 
-String String::joinFromArray (const Array<String>& array, const String& separator)
+Array<StringView> String::splitViews (StringView splitAt, bool clipOffWhiteSpace) const
 {
-    auto result = String();
-    auto num = array.getNumItems();
-
-    for (auto i = 0; i < num; ++i)
-    {
-        result.append (array[i]);
+    return view().split (splitAt, clipOffWhiteSpace);
+}
 
-        if (i < num - 1)
-            result.append (separator);
-    }
 
-    return result;
+StringTokenizer String::splitLazy (StringView splitAt, bool clipOffWhiteSpace) const noexcept
+{
+    return tokenize (view(), splitAt).trimmed (clipOffWhiteSpace);
 }
 
 
 int String::length() const noexcept
 {
-    return details::StringHelpers::stringLength (text);
+    return textLength;
+}
+
+
+int String::getAllocatedSize() const noexcept
+{
+    return allocatedSpace;
+}
+
+
+void String::ensureAllocatedSpace (int minNumChars)
+{
+    if (minNumChars > allocatedSpace)
+        setAllocatedSize (((uint32_t) (minNumChars + minNumChars / 2 + 8)) & ~7u);
 }
 
 
@@ -848,46 +1192,306 @@ void String::print() const noexcept { hosa::print (text); }
 
 char String::operator[] (int index) const noexcept
 {
-    return index < 0 ? text[length() - index - 1] : text[index];
+    return index < 0 ? text[textLength + index] : text[index];
 }
 
 
 const char* String::begin() const noexcept { return text;            }
-const char* String::end()   const noexcept { return text + length(); }
+const char* String::end()   const noexcept { return text + textLength; }
 
 
 char* String::begin() noexcept { return text;            }
-char* String::end()   noexcept { return text + length(); }
+char* String::end()   noexcept { return text + textLength; }
 
 
 String& String::moveFromString (const char* string) noexcept
 {
-    delete[] text;
+    // the string was allocated with new[], so it can only be taken over by a String that uses the heap
+    if (resource != nullptr)
+    {
+        assignNumChars (string, details::StringHelpers::stringLength (string));
+        delete[] string;
+        return *this;
+    }
+
+    freeHeapBuffer();
 
     text = const_cast<char*> (string);
+    textLength = allocatedSpace = details::StringHelpers::stringLength (string);
     return *this;
 }
 
 
-template <typename FirstSub, typename... RestSubs>
-String& String::format (FirstSub firstSub, RestSubs... restSubs)
+char* String::preallocate (int numChars)
+{
+    if (numChars < localBufferSize)
+    {
+        text = localBuffer;
+        allocatedSpace = localBufferSize - 1;
+    }
+    else
+    {
+        text = allocateChars (numChars);
+        allocatedSpace = numChars;
+    }
+
+    textLength = numChars;
+    text[numChars] = '\0';
+    return text;
+}
+
+
+String String::withLength (int numChars, MemoryResource* resource)
+{
+    auto result = String();
+    result.resource = resource;
+    result.preallocate (numChars);
+    return result;
+}
+
+
+String& String::appendNumChars (const char* string, int numChars)
 {
-    format (firstSub);
-    return format (restSubs...);
+    if (textLength + numChars > allocatedSpace)
+    {
+        // the chars to append might live in this String, which is about to move
+        auto offset = pointsIntoBuffer (string) ? string - text : -1;
+        ensureAllocatedSpace (textLength + numChars);
+
+        if (offset >= 0)
+            string = text + offset;
+    }
+
+    memcpy (text + textLength, string, numChars * sizeof (char));
+    textLength += numChars;
+    text[textLength] = '\0';
+    return *this;
 }
 
 
-template <typename Substitution>
-String& String::format (Substitution substitution)
+template <typename WriteFunction>
+String& String::appendWritten (int maxNumChars, WriteFunction&& write)
 {
-    return replace ("{}", String (substitution).toRawUTF8());
+    // the worst case is rarely needed, so if that doesn't fit it's written on the stack
+    // first, to only grow this String when the actual chars don't fit either
+    constexpr int maxCharsOnStack = 64;
+
+    if (textLength + maxNumChars > allocatedSpace && maxNumChars <= maxCharsOnStack)
+    {
+        char buffer[maxCharsOnStack];
+        return appendNumChars (buffer, write (buffer));
+    }
+
+    ensureAllocatedSpace (textLength + maxNumChars);
+    textLength += write (text + textLength);
+    text[textLength] = '\0';
+    return *this;
 }
 
 
-template <typename FirstSub, typename... RestSubs>
-String String::formatted (FirstSub firstSub, RestSubs... restSubs) const
+String& String::assignNumChars (const char* string, int numChars)
 {
-    return String (*this).format (firstSub, restSubs...);
+    if (numChars > allocatedSpace)
+    {
+        auto result = withLength (numChars, resource);
+        memcpy (result.text, string, numChars * sizeof (char));
+        return *this = std::move (result);
+    }
+
+    memmove (text, string, numChars * sizeof (char));
+    textLength = numChars;
+    text[textLength] = '\0';
+    return *this;
+}
+
+
+String& String::replaceNumChars (int index, int numCharsToRemove, const char* replaceWith, int replaceWithLength)
+{
+    if (pointsIntoBuffer (replaceWith))
+        return replaceNumChars (index, numCharsToRemove, String (replaceWith, replaceWithLength).text, replaceWithLength);
+
+    auto newLength = textLength - numCharsToRemove + replaceWithLength;
+    ensureAllocatedSpace (newLength);
+
+    auto* tail = text + index + numCharsToRemove;
+    memmove (text + index + replaceWithLength, tail, (textLength - index - numCharsToRemove) * sizeof (char));
+    memcpy (text + index, replaceWith, replaceWithLength * sizeof (char));
+
+    textLength = newLength;
+    text[textLength] = '\0';
+    return *this;
+}
+
+
+String& String::replaceAllNumChars (const char* toReplace, int toReplaceLength,
+                                    const char* replaceWith, int replaceWithLength)
+{
+    if (toReplaceLength == 0)
+        return *this;
+
+    if (pointsIntoBuffer (toReplace) || pointsIntoBuffer (replaceWith))
+        return replaceAllNumChars (String (toReplace, toReplaceLength).text, toReplaceLength,
+                                   String (replaceWith, replaceWithLength).text, replaceWithLength);
+
+    auto findNext = [this, toReplace, toReplaceLength] (int startIndex)
+    {
+        auto index = details::StringSearch::find (text + startIndex, textLength - startIndex, toReplace, toReplaceLength);
+        return index < 0 ? index : index + startIndex;
+    };
+
+    auto index = findNext (0);
+
+    if (index < 0)
+        return *this;
+
+    // when the String doesn't grow, the chars can be shifted to the front while replacing
+    // and the write position never passes the read position
+    auto* destination = text;
+    auto readIndex = 0;
+
+    if (replaceWithLength > toReplaceLength)
+    {
+        auto numMatches = 0;
+
+        for (auto i = index; i >= 0; i = findNext (i + toReplaceLength))
+            ++numMatches;
+
+        auto result = withLength (textLength + numMatches * (replaceWithLength - toReplaceLength), resource);
+        destination = result.text;
+
+        for (; index >= 0; index = findNext (readIndex))
+        {
+            memcpy (destination, text + readIndex, (index - readIndex) * sizeof (char));
+            memcpy (destination + index - readIndex, replaceWith, replaceWithLength * sizeof (char));
+            destination += index - readIndex + replaceWithLength;
+            readIndex = index + toReplaceLength;
+        }
+
+        memcpy (destination, text + readIndex, (textLength - readIndex) * sizeof (char));
+        return *this = std::move (result);
+    }
+
+    for (; index >= 0; index = findNext (readIndex))
+    {
+        memmove (destination, text + readIndex, (index - readIndex) * sizeof (char));
+        memcpy (destination + index - readIndex, replaceWith, replaceWithLength * sizeof (char));
+        destination += index - readIndex + replaceWithLength;
+        readIndex = index + toReplaceLength;
+    }
+
+    memmove (destination, text + readIndex, (textLength - readIndex) * sizeof (char));
+    textLength = static_cast<int> (destination - text) + textLength - readIndex;
+    text[textLength] = '\0';
+    return *this;
+}
+
+
+void String::setAllocatedSize (int newNumChars)
+{
+    auto* newText = allocateChars (newNumChars);
+    memcpy (newText, text, (textLength + 1) * sizeof (char));
+
+    freeHeapBuffer();
+    text = newText;
+    allocatedSpace = newNumChars;
+}
+
+
+bool String::isUsingLocalBuffer() const noexcept
+{
+    return text == localBuffer;
+}
+
+
+bool String::pointsIntoBuffer (const char* string) const noexcept
+{
+    return string >= text && string <= text + allocatedSpace;
+}
+
+
+void String::takeBufferFrom (String& other) noexcept
+{
+    resource = other.resource;
+    textLength = other.textLength;
+    allocatedSpace = other.allocatedSpace;
+
+    if (other.isUsingLocalBuffer())
+    {
+        memcpy (localBuffer, other.localBuffer, localBufferSize * sizeof (char));
+        text = localBuffer;
+        return;
+    }
+
+    text = other.text;
+    other.text = other.localBuffer;
+    other.textLength = 0;
+    other.allocatedSpace = localBufferSize - 1;
+    other.localBuffer[0] = '\0';
+}
+
+
+char* String::allocateChars (int numChars) const
+{
+    if (resource == nullptr)
+        return details::StringHelpers::nullTerminatedEmptyStringOfLength (numChars);
+
+    auto* chars = static_cast<char*> (resource->allocate ((std::size_t) numChars + 1, alignof (char)));
+    chars[numChars] = '\0';
+    return chars;
+}
+
+
+void String::freeHeapBuffer() noexcept
+{
+    if (isUsingLocalBuffer())
+        return;
+
+    if (resource == nullptr)
+        delete[] text;
+    else
+        resource->deallocate (text, (std::size_t) allocatedSpace + 1, alignof (char));
+}
+
+
+template <typename... Arguments>
+String& String::format (const Arguments&... arguments)
+{
+    return *this = formatted (arguments...);
+}
+
+
+template <typename... Arguments>
+String String::formatted (const Arguments&... arguments) const
+{
+    using StringHelpers = details::StringHelpers;
+    constexpr auto numArguments = sizeof... (arguments);
+
+    // numbers get rendered into the arguments themselves, so the only allocation is the result
+    const std::array<StringHelpers::FormatArgument, numArguments> formatArguments { arguments... };
+    auto places = StringHelpers::findInterpolationPlaces<numArguments> (text);
+    auto result = withLength (StringHelpers::formattedLength (textLength, places, formatArguments));
+
+    StringHelpers::writeFormatted (result.text, text, textLength, places, formatArguments);
+    return result;
 }
 
 } // namespace hosa
+
+
+namespace std
+{
+    template <>
+    struct hash<hosa::String>
+    {
+        std::size_t operator() (const hosa::String& string) const noexcept
+        {
+            return static_cast<std::size_t> (string.hash());
+        }
+    };
+}
+
+// operator+ and the expression it builds
+#include "hosa_Concatenation.h"
+
+// also home to joinFromArray and operator*, which are built on it
+#include "hosa_StringBuilder.h"
@@ -0,0 +1,242 @@
+/*
+    Copyright (C)2020 Wouter Ensink
+
+    This file is part of the Hosa [Header Only String & Array] C++ Project
+        - see the github page to find out more: www.github.com/w-ensink/hosa
+
+    The code in this file is provided under the terms of the ISC license:
+    Permission to use, copy, modify, and/or distribute this software for any purpose with
+    or without fee is hereby granted, provided that the above copyright notice and this
+    permission notice appear in all copies.
+
+    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO
+    THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT
+    SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR
+    ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF
+    CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE
+    OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <utility>
+#include "hosa_String.h"
+
+namespace hosa
+{
+
+/** Builds up a String piece by piece, for when the end result isn't known up front.
+
+    The buffer grows geometrically, and clear() keeps it, so a builder that's reused (one per
+    thread for example) soon stops allocating at all. Numbers and format arguments are rendered
+    straight into the buffer. When done, release() hands the buffer over to a String without
+    copying it.
+
+    @code
+    auto builder = StringBuilder (256);
+    builder << "HTTP/1.1 " << status << "\r\n";
+    builder.appendFormat ("Content-Length: {}\r\n", body.length());
+    auto response = builder.release();
+    @endcode
+ */
+class StringBuilder final
+{
+public:
+
+    StringBuilder() = default;
+
+    explicit StringBuilder (int initialCapacity)
+    {
+        reserve (initialCapacity);
+    }
+
+    StringBuilder (StringBuilder&& other) noexcept
+        : buffer (std::exchange (other.buffer, nullptr)),
+          numChars (std::exchange (other.numChars, 0)),
+          capacity (std::exchange (other.capacity, 0))
+    {
+    }
+
+    StringBuilder& operator= (StringBuilder&& other) noexcept
+    {
+        std::swap (buffer, other.buffer);
+        std::swap (numChars, other.numChars);
+        std::swap (capacity, other.capacity);
+        return *this;
+    }
+
+    StringBuilder (const StringBuilder&) = delete;
+    StringBuilder& operator= (const StringBuilder&) = delete;
+
+    ~StringBuilder() { delete[] buffer; }
+
+    //==============================================================================
+
+    /** Makes sure the given number of chars fit without reallocating. */
+    void reserve (int minNumChars)
+    {
+        if (minNumChars > capacity)
+            setCapacity (minNumChars);
+    }
+
+    /** Empties the builder, but keeps its buffer around for what gets built next. */
+    void clear() noexcept { numChars = 0; }
+
+    [[nodiscard]] int length() const noexcept      { return numChars;      }
+    [[nodiscard]] int getCapacity() const noexcept { return capacity;      }
+    [[nodiscard]] bool isEmpty() const noexcept    { return numChars == 0; }
+
+    /** A view on what's been built so far, only valid until the next change to the builder. */
+    [[nodiscard]] StringView view() const noexcept { return { buffer == nullptr ? "" : buffer, numChars }; }
+
+    /** Returns a copy of what's been built so far, leaving the builder as it is. */
+    [[nodiscard]] String toString() const { return String (view()); }
+
+    /** Hands what's been built over to a String and leaves the builder empty.
+        Text that fits inside a String itself is copied and the builder keeps its buffer,
+        otherwise the buffer is given to the String as it is.
+     */
+    [[nodiscard]] String release()
+    {
+        if (numChars < String::localBufferSize)
+        {
+            auto result = toString();
+            clear();
+            return result;
+        }
+
+        buffer[numChars] = '\0';
+
+        auto result = String();
+        result.text = std::exchange (buffer, nullptr);
+        result.textLength = std::exchange (numChars, 0);
+        result.allocatedSpace = std::exchange (capacity, 0);
+        return result;
+    }
+
+    //==============================================================================
+
+    StringBuilder& append (StringView text)
+    {
+        memcpy (makeRoomFor (text.length()), text.data(), (std::size_t) text.length());
+        numChars += text.length();
+        return *this;
+    }
+
+    StringBuilder& append (const char* text)    { return append (StringView (text)); }
+    StringBuilder& append (const String& text)  { return append (text.view());       }
+
+    StringBuilder& append (char character)
+    {
+        *makeRoomFor (1) = character;
+        ++numChars;
+        return *this;
+    }
+
+    template <typename IntegerType, typename = IntegerNumberType<IntegerType>>
+    StringBuilder& append (IntegerType value, bool hexadecimal = false)
+    {
+        numChars += details::NumberFormatting::writeInteger (makeRoomFor (details::NumberFormatting::maxCharsForIntegerType<IntegerType>),
+                                                             value, hexadecimal);
+        return *this;
+    }
+
+    StringBuilder& append (double value, bool scientific = false, int numDecimals = 0)
+    {
+        auto maxNumChars = details::NumberFormatting::maxCharsForDouble (value, scientific, numDecimals);
+        numChars += details::NumberFormatting::writeDouble (makeRoomFor (maxNumChars), value, scientific, numDecimals);
+        return *this;
+    }
+
+    /** Appends the pattern with each {} replaced by the next argument, like String::formatted. */
+    template <typename... Arguments>
+    StringBuilder& appendFormat (const char* pattern, const Arguments&... arguments)
+    {
+        using StringHelpers = details::StringHelpers;
+        constexpr auto numArguments = sizeof... (arguments);
+
+        const std::array<StringHelpers::FormatArgument, numArguments> formatArguments { arguments... };
+        auto places = StringHelpers::findInterpolationPlaces<numArguments> (pattern);
+        auto patternLength = StringHelpers::stringLength (pattern);
+        auto formattedLength = StringHelpers::formattedLength (patternLength, places, formatArguments);
+
+        StringHelpers::writeFormatted (makeRoomFor (formattedLength), pattern, patternLength, places, formatArguments);
+        numChars += formattedLength;
+        return *this;
+    }
+
+    template <typename Type>
+    StringBuilder& operator<< (const Type& value) { return append (value); }
+
+private:
+
+    // returns where the next chars go, after making sure there's room for the given number of them,
+    // this is never nullptr (not even for zero chars), so the result can always be passed to memcpy
+    char* makeRoomFor (int numCharsToAdd)
+    {
+        if (numChars + numCharsToAdd > capacity || buffer == nullptr)
+        {
+            auto minNumChars = numChars + numCharsToAdd;
+            setCapacity (static_cast<int> (((uint32_t) (minNumChars + minNumChars / 2 + 8)) & ~7u));
+        }
+
+        return buffer + numChars;
+    }
+
+    // one more char than the capacity is allocated, so release() can always add a terminator
+    void setCapacity (int newCapacity)
+    {
+        auto* newBuffer = new char[(std::size_t) newCapacity + 1];
+
+        if (buffer != nullptr)
+            memcpy (newBuffer, buffer, (std::size_t) numChars);
+
+        delete[] buffer;
+        buffer = newBuffer;
+        capacity = newCapacity;
+    }
+
+    char* buffer = nullptr;
+    int numChars = 0;
+    int capacity = 0;
+};
+
+
+//==============================================================================
+
+String operator* (const String& lhs, int rhs)
+{
+    auto builder = StringBuilder (rhs > 0 ? lhs.length() * rhs : 0);
+
+    while (--rhs >= 0)
+        builder.append (lhs);
+
+    return builder.release();
+}
+
+
+String String::joinFromArray (const Array<String>& array, const String& separator)
+{
+    auto num = array.getNumItems();
+    auto totalLength = num > 0 ? (num - 1) * separator.textLength : 0;
+
+    for (auto& item : array)
+        totalLength += item.textLength;
+
+    auto builder = StringBuilder (totalLength);
+
+    for (auto i = 0; i < num; ++i)
+    {
+        if (i > 0)
+            builder.append (separator);
+
+        builder.append (array[i]);
+    }
+
+    return builder.release();
+}
+
+} // namespace hosa
@@ -20,8 +20,13 @@
 
 #pragma once
 
-#include <sstream>
+#include <array>
+#include <cstring>
 #include "../utility/hosa_Utility.h"
+#include "hosa_CaseConversion.h"
+#include "hosa_NumberFormatting.h"
+#include "hosa_NumberParsing.h"
+#include "hosa_StringSearch.h"
 
 
 namespace hosa::details
@@ -36,22 +41,22 @@ struct CharHelpers final
     
     static constexpr char toUpperCase (char c) noexcept
     {
-        return isUpperCase (c) ? c : toggleCase (c);
+        return CaseConversion::toUpperCase (c);
     }
     
     static constexpr char toLowerCase (char c) noexcept
     {
-        return isLowerCase (c) ? c : toggleCase (c);
+        return CaseConversion::toLowerCase (c);
     }
     
     static constexpr bool isLowerCase (char c) noexcept
     {
-        return ((c & 0x20) >> 0x5) == 0x1;
+        return c >= 'a' && c <= 'z';
     }
     
     static constexpr bool isUpperCase (char c) noexcept
     {
-        return ! isLowerCase (c);
+        return c >= 'A' && c <= 'Z';
     }
     
     static constexpr int compare (char lhs, char rhs) noexcept
@@ -97,94 +102,75 @@ struct CharHelpers final
 
 
 
+//=======================================================================================
+
+template <typename T, typename = void>
+struct HasToRawUTF8 : std::false_type {};
+
+template <typename T>
+struct HasToRawUTF8<T, std::void_t<decltype (std::declval<const T&>().toRawUTF8())>> : std::true_type {};
+
 //=======================================================================================
 
 class StringHelpers
 {
 public:
     
-    template <typename CharType = char, typename Traits = std::char_traits<CharType>>
-    class NumericStream    : public std::basic_streambuf<CharType, Traits>
+    /** One argument of a format call, as text.
+        Strings are referred to, numbers and chars are rendered into the argument itself,
+        so formatting never needs temporary heap Strings for its arguments.
+     */
+    class FormatArgument final
     {
-    public:
+        char buffer[NumberFormatting::maxCharsForWideInteger];
         
-        using StreamBuffer = std::basic_streambuf<CharType, Traits>;
+    public:
         
-        explicit NumericStream (CharType* stream)
+        FormatArgument (const char* string) noexcept
+            : text (string), length (stringLength (string))
         {
-            static const std::locale locale  (std::locale::classic());
-            StreamBuffer::imbue (locale);
-            StreamBuffer::setp (stream, stream + StringHelpers::charsNeededForDouble);
-            StreamBuffer::setg (stream, stream, stream + stringLength (stream));
         }
         
-        
-        std::size_t writeDouble (double number, int decimals, bool useScientificNotation)
+        FormatArgument (char character) noexcept
+            : text (buffer), length (1)
         {
-            {
-                std::ostream stream (this);
-            
-                if (decimals > 0)
-                {
-                    stream.setf (useScientificNotation ? std::ios_base::scientific : std::ios_base::fixed);
-                    stream.precision ((std::streamsize) decimals);
-                }
-            
-                stream << number;
-            }
-            
-            auto length = (std::size_t) (StreamBuffer::pptr() - StreamBuffer::pbase());
-            
-            return length;
+            buffer[0] = character;
         }
         
-        
-        double readDouble (bool scientific)
+        template <typename IntegerType, IntegerNumberType<IntegerType, int> = 0>
+        FormatArgument (IntegerType value) noexcept
+            : text (buffer), length (NumberFormatting::writeInteger (buffer, value))
         {
-            double value = 0.0;
-            {
-                std::istream stream (this);
-                
-                if (scientific)
-                    stream.flags (std::ios_base::scientific);
-                
-                stream >> value;
-            }
-            
-            return value;
         }
         
+        template <typename FloatType, std::enable_if_t<std::is_floating_point_v<FloatType>, int> = 0>
+        FormatArgument (FloatType value) noexcept
+            : text (buffer), length (NumberFormatting::writeDouble (buffer, static_cast<double> (value)))
+        {
+        }
         
-        std::size_t writeInteger (int number, bool hexadecimal)
+        // anything that looks like a String
+        template <typename StringType, typename = decltype (std::declval<const StringType&>().toRawUTF8())>
+        FormatArgument (const StringType& string) noexcept
+            : text (string.toRawUTF8()), length (string.length())
         {
-            {
-                std::ostream stream (this);
-                
-                if (hexadecimal)
-                    stream.flags (std::ios_base::hex);
-                
-                stream << number;
-            }
-            
-            auto length = (std::size_t) (StreamBuffer::pptr() - StreamBuffer::pbase());
-            return length;
         }
-
-
-        int readInteger (bool hexadecimal)
+        
+        // anything that looks like a view, StringView or std::string for example, but not a String
+        // (SharedString and InternedString have both, and go through the constructor above)
+        template <typename ViewType, typename = decltype (std::declval<const ViewType&>().data()),
+                  std::enable_if_t<! HasToRawUTF8<ViewType>::value, int> = 0>
+        FormatArgument (const ViewType& view) noexcept
+            : text (view.data()), length (static_cast<int> (view.length()))
         {
-            int value = 0;
-            {
-                std::istream stream (this);
-                
-                if (hexadecimal)
-                    stream.flags (std::ios_base::hex);
-                
-                stream >> value;
-            }
-            
-            return value;
         }
+        
+        // text might point into the argument itself, so it can't be copied around
+        FormatArgument (const FormatArgument&) = delete;
+        FormatArgument& operator= (const FormatArgument&) = delete;
+        
+        const char* text;
+        int length;
     };
     
 //=======================================================================================
@@ -211,9 +197,8 @@ public:
         auto firstLen = stringLength (first);
         auto secondLen = stringLength (second);
         auto* temp = nullTerminatedEmptyStringOfLength (firstLen + secondLen);
-    
-        memcpy (&temp[0], first, firstLen * sizeof (char));
-        memcpy (&temp[firstLen], second, secondLen * sizeof (char));
+        
+        writeSpliced (temp, first, firstLen, firstLen, 0, second, secondLen);
         
         return temp;
     }
@@ -238,13 +223,14 @@ public:
     
     static int fullStringCompare (const char* s1, const char* s2) noexcept
     {
-        auto len1 = stringLength (s1);
-        auto len2 = stringLength (s2);
-        auto num = std::min (len1, len2);
-        
-        while (--num >= 0)
-            if (auto diff = CharHelpers::compare (*(s1++), *(s2++)))
-                return diff;
+        return compare (s1, stringLength (s1), s2, stringLength (s2));
+    }
+    
+    
+    static int compare (const char* s1, int len1, const char* s2, int len2) noexcept
+    {
+        if (auto diff = compareNumChars (s1, s2, std::min (len1, len2)))
+            return diff;
         
         return len1 == len2 ? 0 : (len1 > len2 ? 1 : -1);
     }
@@ -252,15 +238,7 @@ public:
     
     static int fullStringCompareIgnoreCase (const char* s1, const char* s2) noexcept
     {
-        auto len1 = stringLength (s1);
-        auto len2 = stringLength (s2);
-        auto num = std::min (len1, len2);
-        
-        while (--num >= 0)
-            if (auto diff = CharHelpers::compareIgnoreCase (*(s1++), *(s2++)))
-                return diff;
-        
-        return len1 == len2 ? 0 : (len1 > len2 ? 1 : -1);
+        return CaseConversion::compareIgnoreCase (s1, stringLength (s1), s2, stringLength (s2));
     }
     
     
@@ -276,51 +254,43 @@ public:
     
     static int compareNumCharsIgnoreCase (const char* s1, const char* s2, int numChars) noexcept
     {
-        while (--numChars >= 0)
-            if (auto diff = CharHelpers::compareIgnoreCase (*(s1++), *(s2++)))
-                return diff;
-        
-        return 0;
+        return CaseConversion::compareIgnoreCase (s1, numChars, s2, numChars);
     }
     
     
-    static bool stringContains (char* toSearch, const char* toFind) noexcept
+    static bool stringContains (const char* toSearch, const char* toFind) noexcept
     {
-        auto len = stringLength (toFind);
-        auto lenRemaining = stringLength (toSearch);
-        
-        while (lenRemaining-- >= len)
-            if (compareNumChars (toSearch++, toFind, len) == 0)
-                return true;
-        
-        return false;
+        return indexOfSubString (toSearch, toFind) >= 0;
     }
     
     
-    static bool containsIgnoreCase (char* toSearch, const char* toFind) noexcept
+    static bool containsIgnoreCase (const char* toSearch, const char* toFind) noexcept
     {
-        auto len = stringLength (toFind);
-        auto lenRemaining = stringLength (toSearch);
-        
-        while (lenRemaining-- >= len)
-            if (compareNumCharsIgnoreCase (toSearch++, toFind, len) == 0)
-                return true;
-        
-        return false;
+        return CaseConversion::findIgnoreCase (toSearch, stringLength (toSearch), toFind, stringLength (toFind)) >= 0;
+    }
+    
+    
+    static void writeLowerCased (char* destination, const char* source, int numChars) noexcept
+    {
+        CaseConversion::writeLowerCased (destination, source, numChars);
+    }
+    
+    
+    static void writeUpperCased (char* destination, const char* source, int numChars) noexcept
+    {
+        CaseConversion::writeUpperCased (destination, source, numChars);
     }
     
     
     static void toUpperCase (char* string) noexcept
     {
-        for (auto i = 0; i < stringLength (string); ++i)
-            string[i] = CharHelpers::toUpperCase (string[i]);
+        CaseConversion::writeUpperCased (string, string, stringLength (string));
     }
     
     
     static void toLowerCase (char* string) noexcept
     {
-        for (auto i = 0; i < stringLength (string); ++i)
-            string[i] = CharHelpers::toLowerCase (string[i]);
+        CaseConversion::writeLowerCased (string, string, stringLength (string));
     }
     
     
@@ -328,10 +298,7 @@ public:
     {
         auto len = stringLength (string);
         auto* temp = nullTerminatedEmptyStringOfLength (len);
-        
-        while (--len >= 0)
-            temp[len] = CharHelpers::toLowerCase (string[len]);
-        
+        writeLowerCased (temp, string, len);
         return temp;
     }
     
@@ -340,28 +307,14 @@ public:
     {
         auto len = stringLength (string);
         auto* temp = nullTerminatedEmptyStringOfLength (len);
-        
-        while (--len >= 0)
-            temp[len] = CharHelpers::toUpperCase (string[len]);
-        
+        writeUpperCased (temp, string, len);
         return temp;
     }
     
     
     static int indexOfSubString (const char* source, const char* toFind) noexcept
     {
-        auto len = stringLength (toFind);
-        auto index = 0;
-        
-        while (index <= stringLength (source) - len)
-        {
-            if (compareNumChars (source + index, toFind, len) == 0)
-                return index;
-            else
-                ++index;
-        }
-   
-        return -1;
+        return StringSearch::find (source, stringLength (source), toFind, stringLength (toFind));
     }
     
     
@@ -372,10 +325,7 @@ public:
         
         auto* temp = nullTerminatedEmptyStringOfLength (srcLen - rmLen);
         
-        auto index = indexOfSubString (source, toRemove);
-        
-        memcpy (temp, source, index * sizeof (char));
-        memcpy (temp + index, source + index + rmLen, (srcLen - index - rmLen) * sizeof (char));
+        writeSpliced (temp, source, srcLen, indexOfSubString (source, toRemove), rmLen, "", 0);
         
         return temp;
     }
@@ -392,8 +342,7 @@ public:
         
         auto* temp = nullTerminatedEmptyStringOfLength (len - numChars);
         
-        memcpy (temp, string, startIndex * sizeof (char));
-        memcpy (temp + startIndex, string + startIndex + numChars, (len - startIndex - numChars) * sizeof (char));
+        writeSpliced (temp, string, len, startIndex, numChars, "", 0);
         
         return temp;
     }
@@ -415,22 +364,48 @@ public:
     }
     
     
-    static char* removeWhiteSpace (const char* source)
+    static void writeWithoutWhiteSpace (char* destination, const char* source, int numChars) noexcept
     {
-        auto* temp = nullTerminatedEmptyStringOfLength (stringLengthIgnoreWhiteSpace (source));
-        auto index = 0;
-        
-        do
+        while (--numChars >= 0)
         {
             if (! CharHelpers::isWhiteSpace (*source))
-                temp[index++] = *source;
+                *(destination++) = *source;
+            
+            ++source;
         }
-        while (*(++source) != '\0');
-        
+    }
+    
+    
+    static char* removeWhiteSpace (const char* source)
+    {
+        auto* temp = nullTerminatedEmptyStringOfLength (stringLengthIgnoreWhiteSpace (source));
+        writeWithoutWhiteSpace (temp, source, stringLength (source));
         return temp;
     }
     
     
+    static int numLeadingWhiteSpace (const char* string, int numChars) noexcept
+    {
+        auto num = 0;
+        
+        while (num < numChars && CharHelpers::isWhiteSpace (string[num]))
+            ++num;
+        
+        return num;
+    }
+    
+    
+    static int numTrailingWhiteSpace (const char* string, int numChars) noexcept
+    {
+        auto num = 0;
+        
+        while (num < numChars && CharHelpers::isWhiteSpace (string[numChars - num - 1]))
+            ++num;
+        
+        return num;
+    }
+    
+    
     static const char* replace (const char* source, const char* toReplace, const char* replaceWith)
     {
         auto srcLen = stringLength (source);
@@ -439,39 +414,59 @@ public:
         
         auto* temp = nullTerminatedEmptyStringOfLength (srcLen - toRepLen + repWithLen);
         
-        auto index = indexOfSubString (source, toReplace);
-        
-        memcpy (temp, source, index * sizeof (char));
-        memcpy (temp + index, replaceWith, repWithLen * sizeof (char));
-        memcpy (temp + index + repWithLen, (source + index + toRepLen), (srcLen - index - toRepLen) * sizeof (char));
+        writeSpliced (temp, source, srcLen, indexOfSubString (source, toReplace), toRepLen, replaceWith, repWithLen);
         
         return temp;
     }
     
     
+    // writes the source to the destination, with the range [index, index + numCharsToRemove)
+    // replaced by toInsert, which is all that insert, remove and replace really are
+    static void writeSpliced (char* destination, const char* source, int sourceLength, int index,
+                              int numCharsToRemove, const char* toInsert, int toInsertLength) noexcept
+    {
+        memcpy (destination, source, index * sizeof (char));
+        memcpy (destination + index, toInsert, toInsertLength * sizeof (char));
+        memcpy (destination + index + toInsertLength, source + index + numCharsToRemove,
+                (sourceLength - index - numCharsToRemove) * sizeof (char));
+    }
+    
+    
     static const char* swap (const char* source, const char* one, const char* two)
     {
         auto len = stringLength (source);
-        auto indexOne = indexOfSubString (source, one);
-        auto indexTwo = indexOfSubString (source, two);
-        auto lenOne = stringLength (one);
-        auto lenTwo = stringLength (two);
+        auto* temp = nullTerminatedEmptyStringOfLength (len);
+        
+        writeSwapped (temp, source, len, indexOfSubString (source, one), stringLength (one),
+                      indexOfSubString (source, two), stringLength (two));
         
+        return temp;
+    }
+    
+    
+    static void writeSwapped (char* destination, const char* source, int sourceLength,
+                              int indexOne, int lenOne, int indexTwo, int lenTwo) noexcept
+    {
         if (indexOne > indexTwo)
         {
             std::swap (indexOne, indexTwo);
             std::swap (lenOne,   lenTwo);
         }
         
-        auto* temp = nullTerminatedEmptyStringOfLength (stringLength (source));
-       
-        memcpy (temp, source, indexOne * sizeof (char));
-        memcpy (temp + indexOne, source + indexTwo, lenTwo * sizeof(char));
-        memcpy (temp + indexOne + lenTwo, source + indexOne + lenOne, (indexTwo - indexOne) * sizeof (char));
-        memcpy (temp + lenTwo + indexTwo - lenOne, source + indexOne, lenOne * sizeof (char));
-        memcpy (temp + indexTwo + lenTwo, source + indexTwo + lenTwo, len - (indexTwo + lenTwo) * sizeof (char));
+        memcpy (destination, source, indexOne * sizeof (char));
+        memcpy (destination + indexOne, source + indexTwo, lenTwo * sizeof (char));
+        memcpy (destination + indexOne + lenTwo, source + indexOne + lenOne, (indexTwo - indexOne - lenOne) * sizeof (char));
+        memcpy (destination + lenTwo + indexTwo - lenOne, source + indexOne, lenOne * sizeof (char));
+        memcpy (destination + indexTwo + lenTwo, source + indexTwo + lenTwo, (sourceLength - indexTwo - lenTwo) * sizeof (char));
+    }
+    
+    
+    static void writeReversed (char* destination, const char* source, int numChars) noexcept
+    {
+        auto* sourceEnd = source + numChars;
         
-        return temp;
+        while (sourceEnd != source)
+            *(destination++) = *(--sourceEnd);
     }
     
     
@@ -479,11 +474,7 @@ public:
     {
         auto len = stringLength (toReverse);
         auto* temp = nullTerminatedEmptyStringOfLength (len);
-        auto remaining = len--;
-        
-        while (--remaining >= 0)
-            temp [len - remaining] = toReverse [remaining];
-        
+        writeReversed (temp, toReverse, len);
         return temp;
     }
     
@@ -498,9 +489,7 @@ public:
         
         auto* temp = nullTerminatedEmptyStringOfLength (srcLen + destLen);
         
-        memcpy (temp, insertIn, index * sizeof (char));
-        memcpy (temp + index, toInsert, srcLen * sizeof (char));
-        memcpy (temp + index + srcLen , insertIn + index, (destLen - index) * sizeof (char));
+        writeSpliced (temp, insertIn, destLen, index, 0, toInsert, srcLen);
         
         return temp;
     }
@@ -508,20 +497,11 @@ public:
     
     static const char* clipOffWhiteSpace (const char* string)
     {
-        auto oldLen = stringLength (string);
-        auto* begin = string;
-        auto* end = string + oldLen;
-        
-        while (CharHelpers::isWhiteSpace (*(begin))) ++begin;
-        while (CharHelpers::isWhiteSpace (*(end - 1))) --end;
-        
-        auto* temp = nullTerminatedEmptyStringOfLength (static_cast<int> (end - begin));
-        auto index = 0;
-        
-        while (begin != end)
-            temp[index++] = *(begin++);
+        auto len = stringLength (string);
+        auto numLeading = numLeadingWhiteSpace (string, len);
+        auto numTrailing = numTrailingWhiteSpace (string + numLeading, len - numLeading);
         
-        return temp;
+        return allocateAndCopyNumChars (string + numLeading, len - numLeading - numTrailing);
     }
     
     
@@ -535,35 +515,28 @@ public:
 
     static const char* intToString (int value, bool hexadecimal = false)
     {
-        auto* buffer = nullTerminatedEmptyStringOfLength (charsNeededForInt);
-        NumericStream (buffer).writeInteger (value, hexadecimal);
-        
-        if (! hexadecimal)
-            return buffer;
-        
-        auto* toReturn = buildStringFromPointers ("0x", buffer);
-        delete[] buffer;
-        return toReturn;
+        char buffer[NumberFormatting::maxCharsForInteger];
+        return allocateAndCopyNumChars (buffer, NumberFormatting::writeInteger (buffer, value, hexadecimal));
     }
     
     
     static const char* doubleToString (double value, bool useScientificNotation = false, int decimals = 0)
     {
-        auto* buffer = nullTerminatedEmptyStringOfLength (charsNeededForDouble);
-        NumericStream (buffer).writeDouble (value, decimals, useScientificNotation);
-        return buffer;
+        auto* temp = nullTerminatedEmptyStringOfLength (NumberFormatting::maxCharsForDouble (value, useScientificNotation, decimals));
+        temp[NumberFormatting::writeDouble (temp, value, useScientificNotation, decimals)] = '\0';
+        return temp;
     }
 
     
-    static double stringToDouble (const char* string, bool scientific = false)
+    static double stringToDouble (const char* string)
     {
-        return NumericStream (const_cast<char*> (string)).readDouble (scientific);
+        return NumberParsing::parse<double> (string, stringLength (string)).value;
     }
     
     
     static int stringToInteger (const char* string, bool hexadecimal = false)
     {
-        return NumericStream (const_cast<char*> (string)).readInteger (hexadecimal);
+        return NumberParsing::parse<int> (string, stringLength (string), hexadecimal).value;
     }
     
     
@@ -581,12 +554,13 @@ public:
     }
 
 
-    // finding the start indices (as pointers) of all {} in a string
+    // finding the start indices (as pointers) of all {} in a string,
+    // when there are less {} than asked for, the remaining pointers are nullptr
     template <std::size_t NumSubsToLookFor>
     static auto findInterpolationPlaces (const char* findIn) noexcept -> std::array<const char*, NumSubsToLookFor>
     {
-        std::array<const char*, NumSubsToLookFor> startPointers;
-        auto index = 0;
+        std::array<const char*, NumSubsToLookFor> startPointers {};
+        std::size_t index = 0;
 
         while (index < NumSubsToLookFor && *findIn != '\0')
         {
@@ -615,36 +589,52 @@ public:
     // instead of a series of replace's (which would need many allocations)
     // we can do it with some smart template programming and a single allocation
     template <typename... Ts>
-    static char* format (const char* toFormat, Ts&&... inserts)
+    static char* format (const char* toFormat, const Ts&... inserts)
     {
-        static_assert ((std::is_same_v<const char*, std::decay_t<Ts>> && ...), "C strings required");
-
         constexpr auto numSubstitutions = sizeof... (inserts);
-        auto newStringLength = (stringLength (inserts) + ...) + stringLength (toFormat) - sizeof... (inserts) * 2;
+        auto formatLength = stringLength (toFormat);
+
+        const std::array<FormatArgument, numSubstitutions> substitutions {inserts...};
+        auto interpolationPlaces = findInterpolationPlaces<numSubstitutions> (toFormat);
+
+        auto* buffer = nullTerminatedEmptyStringOfLength (formattedLength (formatLength, interpolationPlaces, substitutions));
+        writeFormatted (buffer, toFormat, formatLength, interpolationPlaces, substitutions);
 
-        auto* buffer = nullTerminatedEmptyStringOfLength (newStringLength);
-        auto* destination = buffer;
+        return buffer;
+    }
 
-        std::array<const char*, numSubstitutions> substitutions {inserts...};
-        auto interpolationIndices = findInterpolationPlaces<numSubstitutions> (toFormat);
 
-        for (auto i = 0; i < numSubstitutions; ++i, toFormat += 2)
+    // the length of the result of interpolating the substitutions into the places found in a format string
+    template <std::size_t NumSubstitutions>
+    static int formattedLength (int formatLength,
+                                const std::array<const char*, NumSubstitutions>& interpolationPlaces,
+                                const std::array<FormatArgument, NumSubstitutions>& substitutions) noexcept
+    {
+        for (std::size_t i = 0; i < NumSubstitutions && interpolationPlaces[i] != nullptr; ++i)
+            formatLength += substitutions[i].length - 2;
+
+        return formatLength;
+    }
+
+
+    template <std::size_t NumSubstitutions>
+    static void writeFormatted (char* destination, const char* toFormat, int formatLength,
+                                const std::array<const char*, NumSubstitutions>& interpolationPlaces,
+                                const std::array<FormatArgument, NumSubstitutions>& substitutions) noexcept
+    {
+        auto* formatEnd = toFormat + formatLength;
+
+        for (std::size_t i = 0; i < NumSubstitutions && interpolationPlaces[i] != nullptr; ++i, toFormat += 2)
         {
-            auto subIndex = interpolationIndices[i];
-            auto subStr = substitutions[i];
+            auto* subStr = substitutions[i].text;
 
-            writeAndAdvanceSourceAndDestination (destination, toFormat, subIndex - toFormat);
-            writeAndAdvanceSourceAndDestination (destination, subStr, stringLength (subStr));
+            writeAndAdvanceSourceAndDestination (destination, toFormat, interpolationPlaces[i] - toFormat);
+            writeAndAdvanceSourceAndDestination (destination, subStr, substitutions[i].length);
         }
 
-        writeAndAdvanceSourceAndDestination (destination, toFormat, stringLength (toFormat));
-
-        return buffer;
+        writeAndAdvanceSourceAndDestination (destination, toFormat, formatEnd - toFormat);
     }
-    
-    
-    static constexpr auto charsNeededForDouble = 48;
-    static constexpr auto charsNeededForInt = 32;
+
 };
 
 } // namespace hosa::details
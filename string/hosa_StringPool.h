@@ -0,0 +1,362 @@
+/*
+    Copyright (C)2020 Wouter Ensink
+
+    This file is part of the Hosa [Header Only String & Array] C++ Project
+        - see the github page to find out more: www.github.com/w-ensink/hosa
+
+    The code in this file is provided under the terms of the ISC license:
+    Permission to use, copy, modify, and/or distribute this software for any purpose with
+    or without fee is hereby granted, provided that the above copyright notice and this
+    permission notice appear in all copies.
+
+    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO
+    THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT
+    SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR
+    ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF
+    CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE
+    OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <ostream>
+#include "../utility/hosa_DynamicMemoryBlock.h"
+#include "hosa_String.h"
+
+namespace hosa
+{
+
+namespace details
+{
+
+/** How an interned text is stored in the pool: its hash and length, directly followed by the chars. */
+struct InternedStringEntry
+{
+    std::uint64_t hash;
+    int length;
+
+    [[nodiscard]] const char* chars() const noexcept { return reinterpret_cast<const char*> (this + 1); }
+};
+
+} // namespace details
+
+
+/** A handle to text that was interned by a StringPool.
+
+    Every distinct text is stored only once per pool, so two handles from the same pool are equal
+    exactly when they point to the same text: comparing them is a pointer comparison, and hashing
+    them returns the hash that was computed when the text was interned. Handles are as cheap
+    to copy as a pointer and stay valid for as long as their pool exists.
+ */
+class InternedString final
+{
+public:
+
+    /** The empty text, which is equal to an interned empty text from any pool. */
+    constexpr InternedString() noexcept = default;
+
+    [[nodiscard]] const char* toRawUTF8() const noexcept { return entry == nullptr ? "" : entry->chars(); }
+    [[nodiscard]] const char* data() const noexcept      { return toRawUTF8(); }
+    [[nodiscard]] int length() const noexcept            { return entry == nullptr ? 0 : entry->length; }
+    [[nodiscard]] bool isEmpty() const noexcept          { return entry == nullptr; }
+    [[nodiscard]] StringView view() const noexcept       { return { toRawUTF8(), length() }; }
+
+    operator StringView() const noexcept { return view(); }
+
+    [[nodiscard]] String toString() const { return String (view()); }
+
+    /** The hash of the text, which is the same as StringView::hash() of it. */
+    [[nodiscard]] std::uint64_t hash() const noexcept { return entry == nullptr ? StringView().hash() : entry->hash; }
+
+    /** Only meaningful for handles from the same pool. */
+    friend bool operator== (InternedString lhs, InternedString rhs) noexcept { return lhs.entry == rhs.entry; }
+    friend bool operator!= (InternedString lhs, InternedString rhs) noexcept { return lhs.entry != rhs.entry; }
+
+    /** Prints this text to the standard console, handy for debugging or experimentation for example. */
+    void print() const { view().print(); }
+
+private:
+
+    friend class StringPool;
+
+    explicit constexpr InternedString (const details::InternedStringEntry* entry) noexcept
+        : entry (entry)
+    {
+    }
+
+    const details::InternedStringEntry* entry = nullptr;
+};
+
+
+template <typename Traits>
+std::basic_ostream<char, Traits>& operator<< (std::basic_ostream<char, Traits>& stream, InternedString string)
+{
+    return stream << string.view();
+}
+
+//==============================================================================
+
+/** Deduplicates texts that repeat a lot (like metric names or tag keys) into InternedStrings.
+
+    The texts are copied into arenas owned by the pool and are only freed when the pool is destroyed.
+    The pool is split into shards by hash, each with its own lock, table and arena, so threads
+    that intern different texts at the same time rarely wait for each other.
+
+    @code
+    auto& pool = StringPool::getGlobalPool();
+    auto key = pool.intern (tagKey);
+
+    if (key == hostKey)   // a pointer comparison
+        ...
+    @endcode
+ */
+class StringPool final
+{
+public:
+
+    StringPool() = default;
+    ~StringPool() { clear(); }
+
+    StringPool (const StringPool&) = delete;
+    StringPool& operator= (const StringPool&) = delete;
+
+    /** A pool that lives for as long as the program does, for texts that are used all over the place. */
+    static StringPool& getGlobalPool()
+    {
+        static StringPool pool;
+        return pool;
+    }
+
+    //==============================================================================
+
+    /** Returns the handle to the given text, adding it to the pool the first time it's seen. */
+    InternedString intern (StringView text)
+    {
+        if (text.isEmpty())
+            return {};
+
+        auto hash = text.hash();
+        auto& shard = shardFor (hash);
+        const std::lock_guard<std::mutex> lock (shard.mutex);
+        return InternedString (shard.findOrAdd (text, hash));
+    }
+
+    /** Interns all given texts, and returns their handles in the same order.
+        Every shard is locked only once, instead of once per text.
+     */
+    Array<InternedString> internAll (const Array<String>& texts)
+    {
+        auto num = texts.getNumItems();
+        auto hashes = Array<std::uint64_t>();
+        auto result = Array<InternedString>();
+        hashes.ensureAllocatedSpace (num);
+        result.ensureAllocatedSpace (num);
+
+        for (auto& text : texts)
+        {
+            hashes.add (text.view().hash());
+            result.add (InternedString());
+        }
+
+        for (auto& shard : shards)
+        {
+            auto locked = std::unique_lock<std::mutex> (shard.mutex, std::defer_lock);
+
+            for (auto i = 0; i < num; ++i)
+            {
+                if (texts[i].length() == 0 || &shardFor (hashes[i]) != &shard)
+                    continue;
+
+                if (! locked.owns_lock())
+                    locked.lock();
+
+                result[i] = InternedString (shard.findOrAdd (texts[i].view(), hashes[i]));
+            }
+        }
+
+        return result;
+    }
+
+    /** Returns the handle to the given text if it was interned before, or an empty handle if it wasn't. */
+    [[nodiscard]] InternedString find (StringView text)
+    {
+        if (text.isEmpty())
+            return {};
+
+        auto hash = text.hash();
+        auto& shard = shardFor (hash);
+        const std::lock_guard<std::mutex> lock (shard.mutex);
+        return InternedString (shard.find (text, hash));
+    }
+
+    /** The number of distinct texts in the pool. */
+    [[nodiscard]] int getNumStrings()
+    {
+        auto num = 0;
+
+        for (auto& shard : shards)
+        {
+            const std::lock_guard<std::mutex> lock (shard.mutex);
+            num += shard.numEntries;
+        }
+
+        return num;
+    }
+
+    /** Removes all texts from the pool, which makes all handles it gave out invalid. */
+    void clear()
+    {
+        for (auto& shard : shards)
+        {
+            const std::lock_guard<std::mutex> lock (shard.mutex);
+            shard.clear();
+        }
+    }
+
+private:
+
+    using Entry = details::InternedStringEntry;
+
+    class Shard final
+    {
+    public:
+
+        Shard() = default;
+        ~Shard() { clear(); }
+
+        const Entry* find (StringView text, std::uint64_t hash) const noexcept
+        {
+            if (numSlots == 0)
+                return nullptr;
+
+            for (auto slot = hash & (numSlots - 1);; slot = (slot + 1) & (numSlots - 1))
+            {
+                auto* entry = slots[slot];
+
+                if (entry == nullptr)
+                    return nullptr;
+
+                if (entry->hash == hash && StringView (entry->chars(), entry->length) == text)
+                    return entry;
+            }
+        }
+
+        const Entry* findOrAdd (StringView text, std::uint64_t hash)
+        {
+            if (auto* existing = find (text, hash))
+                return existing;
+
+            // keeps the table at most three quarters full, so probe sequences stay short
+            if ((numEntries + 1) * 4 > (int) numSlots * 3)
+                resize (numSlots == 0 ? 64 : numSlots * 2);
+
+            auto* entry = createEntry (text, hash);
+            insert (entry);
+            ++numEntries;
+            return entry;
+        }
+
+        void clear() noexcept
+        {
+            while (arena != nullptr)
+            {
+                auto* previous = *reinterpret_cast<char**> (arena);
+                delete[] arena;
+                arena = previous;
+            }
+
+            slots.free();
+            numSlots = 0;
+            numEntries = 0;
+            arenaUsed = arenaSize = 0;
+        }
+
+        std::mutex mutex;
+        int numEntries = 0;
+
+    private:
+
+        void insert (const Entry* entry) noexcept
+        {
+            auto slot = entry->hash & (numSlots - 1);
+
+            while (slots[slot] != nullptr)
+                slot = (slot + 1) & (numSlots - 1);
+
+            slots[slot] = entry;
+        }
+
+        void resize (std::uint64_t newNumSlots)
+        {
+            auto oldSlots = std::move (slots);
+            auto oldNumSlots = numSlots;
+
+            slots.allocate ((std::size_t) newNumSlots, true);
+            numSlots = newNumSlots;
+
+            for (auto i = (std::uint64_t) 0; i < oldNumSlots; ++i)
+                if (oldSlots[i] != nullptr)
+                    insert (oldSlots[i]);
+        }
+
+        // entries are bumped out of big chunks, which each start with a pointer to the previous chunk
+        const Entry* createEntry (StringView text, std::uint64_t hash)
+        {
+            auto entrySize = (int) ((sizeof (Entry) + (std::size_t) text.length() + 1 + alignof (Entry) - 1) & ~(alignof (Entry) - 1));
+
+            if (arenaUsed + entrySize > arenaSize)
+            {
+                auto headerSize = (int) alignof (Entry) > (int) sizeof (char*) ? (int) alignof (Entry) : (int) sizeof (char*);
+                auto newSize = headerSize + (entrySize > minArenaSize ? entrySize : minArenaSize);
+                auto* newArena = new char[(std::size_t) newSize];
+                *reinterpret_cast<char**> (newArena) = arena;
+                arena = newArena;
+                arenaUsed = headerSize;
+                arenaSize = newSize;
+            }
+
+            auto* entry = new (arena + arenaUsed) Entry { hash, text.length() };
+            auto* chars = reinterpret_cast<char*> (entry + 1);
+            memcpy (chars, text.data(), (std::size_t) text.length());
+            chars[text.length()] = '\0';
+            arenaUsed += entrySize;
+            return entry;
+        }
+
+
+        static constexpr int minArenaSize = 64 * 1024;
+
+        details::DynamicMemoryBlock<const Entry*> slots;
+        std::uint64_t numSlots = 0;
+        char* arena = nullptr;
+        int arenaUsed = 0;
+        int arenaSize = 0;
+    };
+
+
+    // the top bits pick the shard, the bottom bits the slot within it, so they don't correlate
+    static constexpr int numShardBits = 4;
+
+    Shard& shardFor (std::uint64_t hash) noexcept { return shards[hash >> (64 - numShardBits)]; }
+
+    Shard shards[1 << numShardBits];
+};
+
+} // namespace hosa
+
+
+namespace std
+{
+    template <>
+    struct hash<hosa::InternedString>
+    {
+        std::size_t operator() (hosa::InternedString string) const noexcept
+        {
+            return static_cast<std::size_t> (string.hash());
+        }
+    };
+}
@@ -0,0 +1,206 @@
+/*
+    Copyright (C)2020 Wouter Ensink
+
+    This file is part of the Hosa [Header Only String & Array] C++ Project
+        - see the github page to find out more: www.github.com/w-ensink/hosa
+
+    The code in this file is provided under the terms of the ISC license:
+    Permission to use, copy, modify, and/or distribute this software for any purpose with
+    or without fee is hereby granted, provided that the above copyright notice and this
+    permission notice appear in all copies.
+
+    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO
+    THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT
+    SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR
+    ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF
+    CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE
+    OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+
+#pragma once
+
+#include <cstring>
+#include "../utility/hosa_CpuFeatures.h"
+
+namespace hosa::details
+{
+
+/** The substring search that all searching String methods end up in.
+
+    Short needles are found by comparing the first and last char of the needle against
+    16 (SSE2) or 32 (AVX2) positions of the haystack at once, and only doing a full compare
+    where both match. Long needles use Boyer-Moore-Horspool, which can skip ahead by up to
+    the length of the needle. AVX2 is only used when the cpu turns out to support it.
+ */
+class StringSearch final
+{
+public:
+
+    /** Returns the index of the first occurrence of the needle in the haystack, or -1. */
+    static int find (const char* haystack, int haystackLength, const char* needle, int needleLength) noexcept
+    {
+        if (needleLength <= 0)
+            return 0;
+
+        if (needleLength > haystackLength)
+            return -1;
+
+        if (needleLength == 1)
+            return findChar (haystack, haystackLength, needle[0]);
+
+        if (needleLength > longNeedleLength)
+            return findHorspool (haystack, haystackLength, needle, needleLength);
+
+       #if HOSA_AVX2_DISPATCH
+        if (CpuFeatures::hasAVX2())
+            return findAVX2 (haystack, haystackLength, needle, needleLength);
+       #endif
+
+       #if HOSA_SSE2
+        return findSSE2 (haystack, haystackLength, needle, needleLength);
+       #else
+        return findScalar (haystack, haystackLength, needle, needleLength, 0);
+       #endif
+    }
+
+
+    static int findChar (const char* haystack, int haystackLength, char toFind) noexcept
+    {
+        auto* found = static_cast<const char*> (memchr (haystack, toFind, (std::size_t) haystackLength));
+        return found == nullptr ? -1 : static_cast<int> (found - haystack);
+    }
+
+
+    static bool contains (const char* haystack, int haystackLength, const char* needle, int needleLength) noexcept
+    {
+        return find (haystack, haystackLength, needle, needleLength) >= 0;
+    }
+
+
+    // needles longer than this are searched for with Horspool instead of the vectorised filter
+    static constexpr int longNeedleLength = 32;
+
+private:
+
+    static bool matchesAt (const char* haystack, const char* needle, int needleLength) noexcept
+    {
+        return memcmp (haystack + 1, needle + 1, (std::size_t) needleLength - 2) == 0;
+    }
+
+
+    // continues the search from startIndex, used for the tails the vector loops can't handle
+    static int findScalar (const char* haystack, int haystackLength,
+                           const char* needle, int needleLength, int startIndex) noexcept
+    {
+        auto lastStart = haystackLength - needleLength;
+
+        while (startIndex <= lastStart)
+        {
+            auto index = findChar (haystack + startIndex, lastStart - startIndex + 1, needle[0]);
+
+            if (index < 0)
+                return -1;
+
+            startIndex += index;
+
+            if (haystack[startIndex + needleLength - 1] == needle[needleLength - 1]
+                && matchesAt (haystack + startIndex, needle, needleLength))
+                return startIndex;
+
+            ++startIndex;
+        }
+
+        return -1;
+    }
+
+
+    static int findHorspool (const char* haystack, int haystackLength, const char* needle, int needleLength) noexcept
+    {
+        int skipTable[256];
+
+        for (auto& skip : skipTable)
+            skip = needleLength;
+
+        for (auto i = 0; i < needleLength - 1; ++i)
+            skipTable[static_cast<unsigned char> (needle[i])] = needleLength - 1 - i;
+
+        auto lastChar = needle[needleLength - 1];
+        auto index = 0;
+
+        while (index <= haystackLength - needleLength)
+        {
+            auto current = haystack[index + needleLength - 1];
+
+            if (current == lastChar && memcmp (haystack + index, needle, (std::size_t) needleLength - 1) == 0)
+                return index;
+
+            index += skipTable[static_cast<unsigned char> (current)];
+        }
+
+        return -1;
+    }
+
+
+   #if HOSA_SSE2
+    static int findSSE2 (const char* haystack, int haystackLength, const char* needle, int needleLength) noexcept
+    {
+        auto first = _mm_set1_epi8 (needle[0]);
+        auto last  = _mm_set1_epi8 (needle[needleLength - 1]);
+        auto index = 0;
+
+        for (; index + 16 + needleLength - 1 <= haystackLength; index += 16)
+        {
+            auto blockFirst = _mm_loadu_si128 (reinterpret_cast<const __m128i*> (haystack + index));
+            auto blockLast  = _mm_loadu_si128 (reinterpret_cast<const __m128i*> (haystack + index + needleLength - 1));
+            auto matches = _mm_and_si128 (_mm_cmpeq_epi8 (first, blockFirst), _mm_cmpeq_epi8 (last, blockLast));
+            auto mask = static_cast<unsigned int> (_mm_movemask_epi8 (matches));
+
+            while (mask != 0)
+            {
+                auto candidate = index + CpuFeatures::countTrailingZeros (mask);
+
+                if (matchesAt (haystack + candidate, needle, needleLength))
+                    return candidate;
+
+                mask &= mask - 1;
+            }
+        }
+
+        return findScalar (haystack, haystackLength, needle, needleLength, index);
+    }
+   #endif
+
+
+   #if HOSA_AVX2_DISPATCH
+    HOSA_TARGET_AVX2
+    static int findAVX2 (const char* haystack, int haystackLength, const char* needle, int needleLength) noexcept
+    {
+        auto first = _mm256_set1_epi8 (needle[0]);
+        auto last  = _mm256_set1_epi8 (needle[needleLength - 1]);
+        auto index = 0;
+
+        for (; index + 32 + needleLength - 1 <= haystackLength; index += 32)
+        {
+            auto blockFirst = _mm256_loadu_si256 (reinterpret_cast<const __m256i*> (haystack + index));
+            auto blockLast  = _mm256_loadu_si256 (reinterpret_cast<const __m256i*> (haystack + index + needleLength - 1));
+            auto matches = _mm256_and_si256 (_mm256_cmpeq_epi8 (first, blockFirst), _mm256_cmpeq_epi8 (last, blockLast));
+            auto mask = static_cast<unsigned int> (_mm256_movemask_epi8 (matches));
+
+            while (mask != 0)
+            {
+                auto candidate = index + CpuFeatures::countTrailingZeros (mask);
+
+                if (matchesAt (haystack + candidate, needle, needleLength))
+                    return candidate;
+
+                mask &= mask - 1;
+            }
+        }
+
+        return findScalar (haystack, haystackLength, needle, needleLength, index);
+    }
+   #endif
+};
+
+} // namespace hosa::details
@@ -0,0 +1,187 @@
+/*
+    Copyright (C)2020 Wouter Ensink
+
+    This file is part of the Hosa [Header Only String & Array] C++ Project
+        - see the github page to find out more: www.github.com/w-ensink/hosa
+
+    The code in this file is provided under the terms of the ISC license:
+    Permission to use, copy, modify, and/or distribute this software for any purpose with
+    or without fee is hereby granted, provided that the above copyright notice and this
+    permission notice appear in all copies.
+
+    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO
+    THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT
+    SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR
+    ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF
+    CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE
+    OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+
+#pragma once
+
+#include <iterator>
+#include "hosa_StringView.h"
+
+namespace hosa
+{
+
+/** Splits text at a separator lazily: the parts are found one at a time while iterating,
+    and handed out as views into the text, so nothing gets allocated or copied.
+
+    @code
+    for (auto field : tokenize (line, ",").trimmed().skippingEmpty())
+        ...
+    @endcode
+
+    Stopping early costs nothing, the rest of the text is never searched. The text has to
+    outlive the tokenizer and the views it gives.
+ */
+class StringTokenizer final
+{
+public:
+
+    constexpr StringTokenizer (StringView text, StringView separator) noexcept
+        : text (text), separator (separator)
+    {
+    }
+
+
+    /** Returns a tokenizer that clips the white space off the beginning and end of every part. */
+    [[nodiscard]] constexpr StringTokenizer trimmed (bool shouldTrim = true) const noexcept
+    {
+        auto result = *this;
+        result.trim = shouldTrim;
+        return result;
+    }
+
+    /** Returns a tokenizer that leaves out parts that are empty (after trimming, if enabled). */
+    [[nodiscard]] constexpr StringTokenizer skippingEmpty (bool shouldSkip = true) const noexcept
+    {
+        auto result = *this;
+        result.skipEmpty = shouldSkip;
+        return result;
+    }
+
+    /** Returns a tokenizer that splits at no more than the given number of separators,
+        everything after the last of those is handed out as the final part. Negative means no limit.
+     */
+    [[nodiscard]] constexpr StringTokenizer withMaxSplits (int maxNumSplits) const noexcept
+    {
+        auto result = *this;
+        result.maxSplits = maxNumSplits;
+        return result;
+    }
+
+
+    class Iterator final
+    {
+    public:
+
+        using iterator_category = std::forward_iterator_tag;
+        using value_type        = StringView;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = const StringView*;
+        using reference         = const StringView&;
+
+        Iterator() noexcept = default;
+
+        reference operator*()  const noexcept { return token;  }
+        pointer   operator->() const noexcept { return &token; }
+
+        Iterator& operator++() noexcept
+        {
+            advance();
+            return *this;
+        }
+
+        Iterator operator++ (int) noexcept
+        {
+            auto previous = *this;
+            advance();
+            return previous;
+        }
+
+        bool operator== (const Iterator& other) const noexcept
+        {
+            return atEnd == other.atEnd && (atEnd || token.data() == other.token.data());
+        }
+
+        bool operator!= (const Iterator& other) const noexcept { return ! operator== (other); }
+
+    private:
+
+        friend class StringTokenizer;
+
+        explicit Iterator (const StringTokenizer& owner) noexcept
+            : tokenizer (&owner), atEnd (false)
+        {
+            advance();
+        }
+
+
+        void advance() noexcept
+        {
+            for (;;)
+            {
+                if (reachedLastPart)
+                {
+                    atEnd = true;
+                    return;
+                }
+
+                auto& source = tokenizer->text;
+                auto& splitAt = tokenizer->separator;
+                auto mayStillSplit = tokenizer->maxSplits < 0 || numSplits < tokenizer->maxSplits;
+                auto index = (mayStillSplit && ! splitAt.isEmpty()) ? source.indexOfSubString (splitAt, position) : -1;
+
+                if (index < 0)
+                {
+                    token = StringView (source.data() + position, source.length() - position);
+                    reachedLastPart = true;
+                }
+                else
+                {
+                    token = StringView (source.data() + position, index - position);
+                    position = index + splitAt.length();
+                    ++numSplits;
+                }
+
+                if (tokenizer->trim)
+                    token = token.trimmed();
+
+                if (! (tokenizer->skipEmpty && token.isEmpty()))
+                    return;
+            }
+        }
+
+
+        const StringTokenizer* tokenizer = nullptr;
+        StringView token;
+        int position = 0;
+        int numSplits = 0;
+        bool reachedLastPart = false;
+        bool atEnd = true;
+    };
+
+
+    [[nodiscard]] Iterator begin() const noexcept { return Iterator (*this); }
+    [[nodiscard]] Iterator end()   const noexcept { return {};               }
+
+private:
+
+    StringView text;
+    StringView separator;
+    int maxSplits = -1;
+    bool trim = false;
+    bool skipEmpty = false;
+};
+
+
+/** Lazily splits the text at every occurrence of the separator, see StringTokenizer. */
+[[nodiscard]] constexpr StringTokenizer tokenize (StringView text, StringView separator) noexcept
+{
+    return { text, separator };
+}
+
+} // namespace hosa
@@ -0,0 +1,257 @@
+/*
+    Copyright (C)2020 Wouter Ensink
+
+    This file is part of the Hosa [Header Only String & Array] C++ Project
+        - see the github page to find out more: www.github.com/w-ensink/hosa
+
+    The code in this file is provided under the terms of the ISC license:
+    Permission to use, copy, modify, and/or distribute this software for any purpose with
+    or without fee is hereby granted, provided that the above copyright notice and this
+    permission notice appear in all copies.
+
+    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO
+    THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT
+    SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR
+    ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF
+    CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE
+    OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include "../array/hosa_Array.h"
+#include "../utility/hosa_Hashing.h"
+#include "hosa_StringHelpers.h"
+#include "hosa_UTF8.h"
+
+namespace hosa
+{
+
+/** A read-only look at a range of chars that live somewhere else, like in a String or a big input buffer.
+
+    A view is just a pointer and a length, so taking a substring of it, trimming it or splitting it
+    never allocates or copies any text. The chars aren't guaranteed to be null terminated, and the
+    view doesn't keep them alive: it's up to the caller to make sure they outlive the view.
+ */
+class StringView final
+{
+public:
+
+    constexpr StringView() noexcept = default;
+
+    constexpr StringView (const char* text, int numChars) noexcept
+        : start (text), numChars (numChars)
+    {
+    }
+
+    StringView (const char* nullTerminatedText) noexcept
+        : start (nullTerminatedText), numChars (details::StringHelpers::stringLength (nullTerminatedText))
+    {
+    }
+
+
+    [[nodiscard]] constexpr const char* data()   const noexcept { return start;              }
+    [[nodiscard]] constexpr int length()         const noexcept { return numChars;           }
+    [[nodiscard]] constexpr bool isEmpty()       const noexcept { return numChars == 0;      }
+    [[nodiscard]] constexpr const char* begin()  const noexcept { return start;              }
+    [[nodiscard]] constexpr const char* end()    const noexcept { return start + numChars;   }
+
+    /** Character indexing, negative index returns index starting from the back. */
+    constexpr char operator[] (int index) const noexcept
+    {
+        return index < 0 ? start[numChars + index] : start[index];
+    }
+
+    //==============================================================================
+
+    /** Compares like String::compare does: 1 if this view comes after the given one, -1 if before, 0 if equal. */
+    [[nodiscard]] int compare (StringView other) const noexcept
+    {
+        return details::StringHelpers::compare (start, numChars, other.start, other.numChars);
+    }
+
+    [[nodiscard]] int compareIgnoreCase (StringView other) const noexcept
+    {
+        return details::CaseConversion::compareIgnoreCase (start, numChars, other.start, other.numChars);
+    }
+
+    [[nodiscard]] bool equals (StringView other) const noexcept
+    {
+        return numChars == other.numChars && memcmp (start, other.start, (std::size_t) numChars) == 0;
+    }
+
+    [[nodiscard]] bool equalsIgnoreCase (StringView other) const noexcept
+    {
+        return numChars == other.numChars && details::CaseConversion::equalsIgnoreCase (start, other.start, numChars);
+    }
+
+    friend bool operator== (StringView lhs, StringView rhs) noexcept { return   lhs.equals (rhs);       }
+    friend bool operator!= (StringView lhs, StringView rhs) noexcept { return ! lhs.equals (rhs);       }
+    friend bool operator<  (StringView lhs, StringView rhs) noexcept { return lhs.compare (rhs) <  0;   }
+    friend bool operator<= (StringView lhs, StringView rhs) noexcept { return lhs.compare (rhs) <= 0;   }
+    friend bool operator>  (StringView lhs, StringView rhs) noexcept { return lhs.compare (rhs) >  0;   }
+    friend bool operator>= (StringView lhs, StringView rhs) noexcept { return lhs.compare (rhs) >= 0;   }
+
+    //==============================================================================
+
+    /** Returns index at which the given substring starts within this view, or -1 if it isn't in there.
+        The search starts at the given index, the returned index is counted from the start of the view.
+     */
+    [[nodiscard]] int indexOfSubString (StringView subString, int startFrom = 0) const noexcept
+    {
+        if (startFrom < 0 || startFrom > numChars)
+            return -1;
+
+        auto index = details::StringSearch::find (start + startFrom, numChars - startFrom, subString.start, subString.numChars);
+        return index < 0 ? -1 : index + startFrom;
+    }
+
+    /** Returns the index of the first occurrence of the given char, or -1. */
+    [[nodiscard]] int indexOfChar (char character, int startFrom = 0) const noexcept
+    {
+        if (startFrom < 0 || startFrom >= numChars)
+            return -1;
+
+        auto index = details::StringSearch::findChar (start + startFrom, numChars - startFrom, character);
+        return index < 0 ? -1 : index + startFrom;
+    }
+
+    [[nodiscard]] bool contains (StringView subString) const noexcept
+    {
+        return details::StringSearch::contains (start, numChars, subString.start, subString.numChars);
+    }
+
+    [[nodiscard]] bool containsIgnoreCase (StringView subString) const noexcept
+    {
+        return details::CaseConversion::findIgnoreCase (start, numChars, subString.start, subString.numChars) >= 0;
+    }
+
+    [[nodiscard]] bool startsWith (StringView prefix) const noexcept
+    {
+        return prefix.numChars <= numChars && memcmp (start, prefix.start, (std::size_t) prefix.numChars) == 0;
+    }
+
+    [[nodiscard]] bool endsWith (StringView suffix) const noexcept
+    {
+        return suffix.numChars <= numChars
+                && memcmp (end() - suffix.numChars, suffix.start, (std::size_t) suffix.numChars) == 0;
+    }
+
+    //==============================================================================
+
+    /** Returns the specified part of this view, clipped to the chars that are actually in it. */
+    [[nodiscard]] StringView substring (int startIndex, int numCharsToTake) const noexcept
+    {
+        startIndex = startIndex < 0 ? 0 : (startIndex > numChars ? numChars : startIndex);
+        numCharsToTake = numCharsToTake < 0 ? 0 : numCharsToTake;
+        numCharsToTake = numCharsToTake > numChars - startIndex ? numChars - startIndex : numCharsToTake;
+        return { start + startIndex, numCharsToTake };
+    }
+
+    /** Returns this view without the white space at its beginning and end. */
+    [[nodiscard]] StringView trimmed() const noexcept
+    {
+        auto numLeading = details::StringHelpers::numLeadingWhiteSpace (start, numChars);
+        auto numTrailing = details::StringHelpers::numTrailingWhiteSpace (start + numLeading, numChars - numLeading);
+        return { start + numLeading, numChars - numLeading - numTrailing };
+    }
+
+    /** Splits this view at every occurrence of the separator, like String::split does, but without copying any text. */
+    [[nodiscard]] Array<StringView> split (StringView separator, bool clipOffWhiteSpace = true) const
+    {
+        auto result = Array<StringView>();
+        auto index = separator.numChars > 0 ? indexOfSubString (separator) : -1;
+        auto lastIndex = 0;
+
+        while (index >= 0)
+        {
+            result.add (part (lastIndex, index, clipOffWhiteSpace));
+            lastIndex = index + separator.numChars;
+            index = indexOfSubString (separator, lastIndex);
+        }
+
+        result.add (part (lastIndex, numChars, clipOffWhiteSpace));
+        return result;
+    }
+
+    //==============================================================================
+
+    /** Converts the number at the start of this view to an integer, or returns 0 if there isn't one. */
+    [[nodiscard]] int toInt (bool hexadecimal = false) const noexcept
+    {
+        return parse<int> (hexadecimal).value;
+    }
+
+    /** Converts the number at the start of this view to a double, or returns 0 if there isn't one. */
+    [[nodiscard]] double toDouble() const noexcept
+    {
+        return parse<double>().value;
+    }
+
+    /** Parses the number at the start of this view, see String::parse. */
+    template <typename NumberType>
+    [[nodiscard]] ParseResult<NumberType> parse (bool hexadecimal = false) const noexcept
+    {
+        return details::NumberParsing::parse<NumberType> (start, numChars, hexadecimal);
+    }
+
+    //==============================================================================
+
+    /** A 64 bit hash of the chars in view, equal texts always give the same hash, whatever type they're in. */
+    [[nodiscard]] std::uint64_t hash() const noexcept
+    {
+        return details::Hashing::hashBytes (start, (std::size_t) numChars);
+    }
+
+    /** True if the chars are valid UTF-8, checked 32 bytes at a time when AVX2 is available. */
+    [[nodiscard]] bool isValidUTF8() const noexcept { return details::UTF8::isValid (start, numChars); }
+
+    /** The number of codepoints in the view, which is less than its length when it has multi byte chars. */
+    [[nodiscard]] int codepointLength() const noexcept { return details::UTF8::countCodepoints (start, numChars); }
+
+    /** The codepoints in the view as char32_t, for a range based for loop. */
+    [[nodiscard]] CodepointRange codepoints() const noexcept { return { start, numChars }; }
+
+    /** Prints this view to the standard console, handy for debugging or experimentation for example. */
+    void print() const;
+
+private:
+
+    StringView part (int from, int to, bool trim) const noexcept
+    {
+        auto result = StringView (start + from, to - from);
+        return trim ? result.trimmed() : result;
+    }
+
+    const char* start = "";
+    int numChars = 0;
+};
+
+
+template <typename Traits>
+std::basic_ostream<char, Traits>& operator<< (std::basic_ostream<char, Traits>& stream, StringView view)
+{
+    return stream.write (view.data(), view.length());
+}
+
+
+inline void StringView::print() const { hosa::print (*this); }
+
+} // namespace hosa
+
+
+namespace std
+{
+    template <>
+    struct hash<hosa::StringView>
+    {
+        std::size_t operator() (hosa::StringView view) const noexcept
+        {
+            return static_cast<std::size_t> (view.hash());
+        }
+    };
+}
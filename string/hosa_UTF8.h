@@ -0,0 +1,460 @@
+/*
+    Copyright (C)2020 Wouter Ensink
+
+    This file is part of the Hosa [Header Only String & Array] C++ Project
+        - see the github page to find out more: www.github.com/w-ensink/hosa
+
+    The code in this file is provided under the terms of the ISC license:
+    Permission to use, copy, modify, and/or distribute this software for any purpose with
+    or without fee is hereby granted, provided that the above copyright notice and this
+    permission notice appear in all copies.
+
+    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO
+    THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT
+    SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR
+    ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF
+    CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE
+    OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include "../utility/hosa_CpuFeatures.h"
+
+namespace hosa
+{
+
+namespace details
+{
+
+/** UTF-8 kernels: validating, counting and decoding codepoints, and reversing text per codepoint.
+
+    Validation follows the lookup algorithm of Keiser and Lemire when AVX2 is available: every byte
+    is checked against the one to three bytes before it with three table lookups per 32 bytes, so
+    there's no branching per char. Without AVX2, blocks of 16 ASCII chars are skipped at once and
+    the rest is checked one codepoint at a time.
+ */
+class UTF8 final
+{
+public:
+
+    /** The codepoint that takes the place of bytes that aren't valid UTF-8 while decoding. */
+    static constexpr char32_t replacementCharacter = 0xfffd;
+
+    static constexpr bool isContinuationByte (char c) noexcept
+    {
+        return (static_cast<unsigned char> (c) & 0xc0u) == 0x80u;
+    }
+
+
+    /** True if the chars are valid UTF-8: no overlong encodings, surrogates, codepoints
+        above U+10FFFF or incomplete sequences.
+     */
+    static bool isValid (const char* text, int numChars) noexcept
+    {
+       #if HOSA_AVX2_DISPATCH
+        if (CpuFeatures::hasAVX2())
+            return isValidAVX2 (text, numChars);
+       #endif
+
+        return isValidScalar (text, numChars);
+    }
+
+
+    /** Checks one codepoint at a time, skipping 16 ASCII chars at once when SSE2 is there. */
+    static bool isValidScalar (const char* text, int numChars) noexcept
+    {
+        auto index = 0;
+
+        while (index < numChars)
+        {
+           #if HOSA_SSE2
+            while (index + 16 <= numChars
+                    && _mm_movemask_epi8 (_mm_loadu_si128 (reinterpret_cast<const __m128i*> (text + index))) == 0)
+                index += 16;
+
+            if (index == numChars)
+                break;
+           #endif
+
+            auto length = validSequenceLength (text + index, numChars - index);
+
+            if (length == 0)
+                return false;
+
+            index += length;
+        }
+
+        return true;
+    }
+
+
+    /** The number of codepoints in valid UTF-8, which is the number of chars that aren't
+        continuation bytes. For invalid UTF-8 this is still the number of those chars.
+     */
+    static int countCodepoints (const char* text, int numChars) noexcept
+    {
+        auto index = 0;
+        auto num = 0;
+
+       #if HOSA_AVX2_DISPATCH
+        if (CpuFeatures::hasAVX2())
+            index = countCodepointBlocksAVX2 (text, numChars, num);
+       #endif
+
+       #if HOSA_SSE2
+        // continuation bytes are 0x80 to 0xbf, which are the lowest bytes when seen as signed
+        for (; index + 16 <= numChars; index += 16)
+        {
+            auto chars = _mm_loadu_si128 (reinterpret_cast<const __m128i*> (text + index));
+            auto isLeading = _mm_cmpgt_epi8 (chars, _mm_set1_epi8 (static_cast<char> (0xbf)));
+            num += CpuFeatures::countSetBits (static_cast<unsigned int> (_mm_movemask_epi8 (isLeading)));
+        }
+       #endif
+
+        for (; index < numChars; ++index)
+            if (! isContinuationByte (text[index]))
+                ++num;
+
+        return num;
+    }
+
+
+    /** Decodes the codepoint at the given position and moves the position past it. Bytes that
+        aren't valid UTF-8 are decoded one at a time, as the replacement character.
+     */
+    static char32_t decode (const char*& position, const char* end) noexcept
+    {
+        auto length = validSequenceLength (position, (int) (end - position));
+        auto* bytes = reinterpret_cast<const unsigned char*> (position);
+
+        if (length == 0)
+        {
+            ++position;
+            return replacementCharacter;
+        }
+
+        position += length;
+
+        switch (length)
+        {
+            case 1:  return bytes[0];
+            case 2:  return ((char32_t) (bytes[0] & 0x1fu) << 6)  |  (char32_t) (bytes[1] & 0x3fu);
+            case 3:  return ((char32_t) (bytes[0] & 0x0fu) << 12) | ((char32_t) (bytes[1] & 0x3fu) << 6)
+                              | (char32_t) (bytes[2] & 0x3fu);
+            default: return ((char32_t) (bytes[0] & 0x07u) << 18) | ((char32_t) (bytes[1] & 0x3fu) << 12)
+                              | ((char32_t) (bytes[2] & 0x3fu) << 6) | (char32_t) (bytes[3] & 0x3fu);
+        }
+    }
+
+
+    /** Reverses the order of the codepoints, keeping the bytes within each of them in order.
+        Bytes that aren't valid UTF-8 are reversed as units of their own, like decode() sees them.
+     */
+    static void reverseCodepoints (char* text, int numChars) noexcept
+    {
+        if (! isAllASCII (text, numChars))
+        {
+            // turns every multi byte sequence around, so reversing all bytes puts them back in order
+            for (auto index = 0; index < numChars;)
+            {
+                auto length = validSequenceLength (text + index, numChars - index);
+
+                if (length > 1)
+                    std::reverse (text + index, text + index + length);
+
+                index += length > 0 ? length : 1;
+            }
+        }
+
+        std::reverse (text, text + numChars);
+    }
+
+
+    static bool isAllASCII (const char* text, int numChars) noexcept
+    {
+        auto index = 0;
+
+       #if HOSA_SSE2
+        for (; index + 16 <= numChars; index += 16)
+            if (_mm_movemask_epi8 (_mm_loadu_si128 (reinterpret_cast<const __m128i*> (text + index))) != 0)
+                return false;
+       #endif
+
+        for (; index < numChars; ++index)
+            if (static_cast<unsigned char> (text[index]) >= 0x80u)
+                return false;
+
+        return true;
+    }
+
+
+    /** The length of the valid sequence that starts at the given position, or 0 if it isn't one. */
+    static int validSequenceLength (const char* text, int numChars) noexcept
+    {
+        auto* bytes = reinterpret_cast<const unsigned char*> (text);
+        auto first = bytes[0];
+
+        if (first < 0x80u)
+            return 1;
+
+        // the allowed range of the second byte depends on the first, which rules out overlong
+        // encodings, surrogates and codepoints above U+10FFFF
+        auto length = 0;
+        unsigned char low = 0x80u, high = 0xbfu;
+
+        if (first >= 0xc2u && first <= 0xdfu)       length = 2;
+        else if (first == 0xe0u)                    { length = 3; low = 0xa0u; }
+        else if (first == 0xedu)                    { length = 3; high = 0x9fu; }
+        else if (first >= 0xe1u && first <= 0xefu)  length = 3;
+        else if (first == 0xf0u)                    { length = 4; low = 0x90u; }
+        else if (first >= 0xf1u && first <= 0xf3u)  length = 4;
+        else if (first == 0xf4u)                    { length = 4; high = 0x8fu; }
+        else                                        return 0;
+
+        if (numChars < length || bytes[1] < low || bytes[1] > high)
+            return 0;
+
+        for (auto i = 2; i < length; ++i)
+            if (! isContinuationByte (text[i]))
+                return 0;
+
+        return length;
+    }
+
+private:
+
+   #if HOSA_AVX2_DISPATCH
+    HOSA_TARGET_AVX2
+    static __m256i lookup (__m256i indices, char t0, char t1, char t2, char t3, char t4, char t5, char t6, char t7,
+                           char t8, char t9, char t10, char t11, char t12, char t13, char t14, char t15) noexcept
+    {
+        auto table = _mm256_setr_epi8 (t0, t1, t2, t3, t4, t5, t6, t7, t8, t9, t10, t11, t12, t13, t14, t15,
+                                       t0, t1, t2, t3, t4, t5, t6, t7, t8, t9, t10, t11, t12, t13, t14, t15);
+        return _mm256_shuffle_epi8 (table, indices);
+    }
+
+
+    HOSA_TARGET_AVX2
+    static __m256i highNibbles (__m256i chars) noexcept
+    {
+        return _mm256_and_si256 (_mm256_srli_epi16 (chars, 4), _mm256_set1_epi8 (0x0f));
+    }
+
+
+    // the chars shifted N places to the right, with the last N chars of the previous block in front
+    template <int N>
+    HOSA_TARGET_AVX2
+    static __m256i previous (__m256i chars, __m256i previousChars) noexcept
+    {
+        return _mm256_alignr_epi8 (chars, _mm256_permute2x128_si256 (previousChars, chars, 0x21), 16 - N);
+    }
+
+
+    // returns a non zero byte wherever the chars (seen together with the block before them) are invalid
+    HOSA_TARGET_AVX2
+    static __m256i findErrors (__m256i chars, __m256i previousChars) noexcept
+    {
+        constexpr char tooShort = 1 << 0, tooLong = 1 << 1, overlong3 = 1 << 2, tooLarge = 1 << 3,
+                       surrogate = 1 << 4, overlong2 = 1 << 5, tooLarge1000 = 1 << 6, overlong4 = 1 << 6,
+                       twoContinuations = (char) (1 << 7), carry = tooShort | tooLong | twoContinuations;
+
+        auto previous1 = previous<1> (chars, previousChars);
+
+        auto byte1High = lookup (highNibbles (previous1),
+                                 tooLong, tooLong, tooLong, tooLong, tooLong, tooLong, tooLong, tooLong,
+                                 twoContinuations, twoContinuations, twoContinuations, twoContinuations,
+                                 tooShort | overlong2,
+                                 tooShort,
+                                 tooShort | overlong3 | surrogate,
+                                 tooShort | tooLarge | tooLarge1000 | overlong4);
+
+        auto byte1Low = lookup (_mm256_and_si256 (previous1, _mm256_set1_epi8 (0x0f)),
+                                carry | overlong3 | overlong2 | overlong4,
+                                carry | overlong2,
+                                carry,
+                                carry,
+                                carry | tooLarge,
+                                carry | tooLarge | tooLarge1000,
+                                carry | tooLarge | tooLarge1000,
+                                carry | tooLarge | tooLarge1000,
+                                carry | tooLarge | tooLarge1000,
+                                carry | tooLarge | tooLarge1000,
+                                carry | tooLarge | tooLarge1000,
+                                carry | tooLarge | tooLarge1000,
+                                carry | tooLarge | tooLarge1000,
+                                carry | tooLarge | tooLarge1000 | surrogate,
+                                carry | tooLarge | tooLarge1000,
+                                carry | tooLarge | tooLarge1000);
+
+        auto byte2High = lookup (highNibbles (chars),
+                                 tooShort, tooShort, tooShort, tooShort, tooShort, tooShort, tooShort, tooShort,
+                                 tooLong | overlong2 | twoContinuations | overlong3 | tooLarge1000 | overlong4,
+                                 tooLong | overlong2 | twoContinuations | overlong3 | tooLarge,
+                                 tooLong | overlong2 | twoContinuations | surrogate | tooLarge,
+                                 tooLong | overlong2 | twoContinuations | surrogate | tooLarge,
+                                 tooShort, tooShort, tooShort, tooShort);
+
+        auto specialCases = _mm256_and_si256 (_mm256_and_si256 (byte1High, byte1Low), byte2High);
+
+        // the third and fourth bytes of a sequence must be continuations, which is all the lookups missed
+        auto isThirdByte  = _mm256_subs_epu8 (previous<2> (chars, previousChars), _mm256_set1_epi8 ((char) (0xe0 - 0x80)));
+        auto isFourthByte = _mm256_subs_epu8 (previous<3> (chars, previousChars), _mm256_set1_epi8 ((char) (0xf0 - 0x80)));
+        auto mustBeContinuation = _mm256_and_si256 (_mm256_or_si256 (isThirdByte, isFourthByte), _mm256_set1_epi8 ((char) 0x80));
+
+        return _mm256_xor_si256 (mustBeContinuation, specialCases);
+    }
+
+
+    // non zero if the block ends halfway a sequence, which the next block then has to finish
+    HOSA_TARGET_AVX2
+    static __m256i findIncompleteEnd (__m256i chars) noexcept
+    {
+        auto maxValues = _mm256_setr_epi8 (-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                                           -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                                           (char) (0xf0 - 1), (char) (0xe0 - 1), (char) (0xc0 - 1));
+        return _mm256_subs_epu8 (chars, maxValues);
+    }
+
+
+    struct ValidationState
+    {
+        __m256i errors, previousChars, previousIncomplete;
+    };
+
+
+    HOSA_TARGET_AVX2
+    static void checkBlock (ValidationState& state, __m256i chars) noexcept
+    {
+        if (_mm256_movemask_epi8 (chars) == 0)
+        {
+            // only ASCII, which is fine unless the previous block wasn't finished
+            state.errors = _mm256_or_si256 (state.errors, state.previousIncomplete);
+        }
+        else
+        {
+            state.errors = _mm256_or_si256 (state.errors, findErrors (chars, state.previousChars));
+            state.previousIncomplete = findIncompleteEnd (chars);
+        }
+
+        state.previousChars = chars;
+    }
+
+
+    HOSA_TARGET_AVX2
+    static bool isValidAVX2 (const char* text, int numChars) noexcept
+    {
+        auto state = ValidationState { _mm256_setzero_si256(), _mm256_setzero_si256(), _mm256_setzero_si256() };
+        auto& errors = state.errors;
+        auto index = 0;
+
+        for (; index + 32 <= numChars; index += 32)
+        {
+            checkBlock (state, _mm256_loadu_si256 (reinterpret_cast<const __m256i*> (text + index)));
+
+            // bails out early, but not so often that the check costs much
+            if ((index & 1023) == 0 && ! _mm256_testz_si256 (errors, errors))
+                return false;
+        }
+
+        // the rest is padded with zeros, which also catches a sequence that's cut off at the end
+        char lastBlock[32] {};
+        memcpy (lastBlock, text + index, (std::size_t) (numChars - index));
+        checkBlock (state, _mm256_loadu_si256 (reinterpret_cast<const __m256i*> (lastBlock)));
+
+        return _mm256_testz_si256 (errors, errors) != 0;
+    }
+
+
+    HOSA_TARGET_AVX2
+    static int countCodepointBlocksAVX2 (const char* text, int numChars, int& num) noexcept
+    {
+        auto index = 0;
+
+        for (; index + 32 <= numChars; index += 32)
+        {
+            auto chars = _mm256_loadu_si256 (reinterpret_cast<const __m256i*> (text + index));
+            auto isLeading = _mm256_cmpgt_epi8 (chars, _mm256_set1_epi8 (static_cast<char> (0xbf)));
+            num += CpuFeatures::countSetBits (static_cast<unsigned int> (_mm256_movemask_epi8 (isLeading)));
+        }
+
+        return index;
+    }
+   #endif
+};
+
+} // namespace details
+
+//==============================================================================
+
+/** The codepoints of some UTF-8 text, for a range based for loop:
+    @code
+    for (auto codepoint : text.codepoints())
+        ...
+    @endcode
+    Bytes that aren't valid UTF-8 come out as U+FFFD, one per byte.
+ */
+class CodepointRange final
+{
+public:
+
+    constexpr CodepointRange (const char* text, int numChars) noexcept
+        : start (text), finish (text + numChars)
+    {
+    }
+
+    class Iterator final
+    {
+    public:
+
+        using iterator_category = std::forward_iterator_tag;
+        using value_type        = char32_t;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = const char32_t*;
+        using reference         = char32_t;
+
+        constexpr Iterator (const char* position, const char* end) noexcept
+            : position (position), end (end)
+        {
+        }
+
+        char32_t operator*() const noexcept
+        {
+            auto* p = position;
+            return details::UTF8::decode (p, end);
+        }
+
+        Iterator& operator++() noexcept
+        {
+            details::UTF8::decode (position, end);
+            return *this;
+        }
+
+        /** Where the codepoint starts in the text. */
+        [[nodiscard]] const char* getPosition() const noexcept { return position; }
+
+        bool operator== (const Iterator& other) const noexcept { return position == other.position; }
+        bool operator!= (const Iterator& other) const noexcept { return position != other.position; }
+
+    private:
+
+        const char* position;
+        const char* end;
+    };
+
+    [[nodiscard]] Iterator begin() const noexcept { return { start, finish }; }
+    [[nodiscard]] Iterator end() const noexcept   { return { finish, finish }; }
+
+private:
+
+    const char* start;
+    const char* finish;
+};
+
+} // namespace hosa
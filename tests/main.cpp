@@ -20,6 +20,14 @@
 
 #include "../hosa.h"
 #include <gtest/gtest.h>
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <limits>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 using namespace hosa;
 using namespace hosa::details;
@@ -84,24 +92,1625 @@ TEST_F (StringHelpersTest, StringHelpers)
             StringHelpers::format ("{}, {}!", "hello", "world"), "hello, world!"), 0);
 }
 
+TEST_F (StringHelpersTest, StringSearchMatchesStdString)
+{
+    auto random = 12345u;
+    auto nextRandom = [&random] { random = random * 1103515245u + 12345u; return (random >> 16) & 0x7fff; };
+
+    for (auto round = 0; round < 2000; ++round)
+    {
+        auto haystack = std::string();
+        auto needle = std::string();
+        auto alphabetSize = 2 + (int) nextRandom() % 3;
+
+        for (auto i = (int) nextRandom() % 300; i > 0; --i)
+            haystack += (char) ('a' + nextRandom() % alphabetSize);
+
+        for (auto i = 1 + (int) nextRandom() % 40; i > 0; --i)
+            needle += (char) ('a' + nextRandom() % alphabetSize);
+
+        auto expected = haystack.find (needle);
+        auto found = StringSearch::find (haystack.data(), (int) haystack.size(), needle.data(), (int) needle.size());
+
+        ASSERT_EQ (found, expected == std::string::npos ? -1 : (int) expected) << haystack << " / " << needle;
+    }
+
+    ASSERT_EQ (StringSearch::find ("abc", 3, "", 0), 0);
+    ASSERT_EQ (StringSearch::find ("abc", 3, "abcd", 4), -1);
+}
+
+TEST_F (StringHelpersTest, CaseInsensitiveKernelsMatchScalarVersions)
+{
+    auto random = 777u;
+    auto nextRandom = [&random] { random = random * 1103515245u + 12345u; return (random >> 16) & 0x7fff; };
+    auto* alphabet = "aAbB@[`{zZ1";
+
+    auto scalarCompare = [] (const std::string& lhs, const std::string& rhs)
+    {
+        for (std::size_t i = 0; i < std::min (lhs.size(), rhs.size()); ++i)
+            if (auto diff = CharHelpers::compareIgnoreCase (lhs[i], rhs[i]))
+                return diff;
+
+        return lhs.size() == rhs.size() ? 0 : (lhs.size() > rhs.size() ? 1 : -1);
+    };
+
+    for (auto round = 0; round < 2000; ++round)
+    {
+        auto lhs = std::string();
+        auto rhs = std::string();
+
+        for (auto i = (int) nextRandom() % 100; i > 0; --i)
+            lhs += alphabet[nextRandom() % 11];
+
+        rhs = lhs;
+
+        for (auto& c : rhs)
+            if (nextRandom() % 4 == 0)
+                c = CharHelpers::toggleCase (c);
+
+        if (! rhs.empty() && nextRandom() % 2 == 0)
+            rhs[nextRandom() % rhs.size()] = alphabet[nextRandom() % 11];
+
+        ASSERT_EQ (CaseConversion::compareIgnoreCase (lhs.data(), (int) lhs.size(), rhs.data(), (int) rhs.size()),
+                   scalarCompare (lhs, rhs));
+
+        auto needle = rhs.substr (rhs.size() / 3, 1 + nextRandom() % 8);
+        auto found = CaseConversion::findIgnoreCase (lhs.data(), (int) lhs.size(), needle.data(), (int) needle.size());
+        auto expected = -1;
+
+        for (auto i = 0; expected < 0 && i + (int) needle.size() <= (int) lhs.size(); ++i)
+            if (scalarCompare (lhs.substr ((std::size_t) i, needle.size()), needle) == 0)
+                expected = i;
+
+        ASSERT_EQ (found, expected);
+    }
+
+    ASSERT_FALSE (CharHelpers::isLowerCase ('1'));
+    ASSERT_FALSE (CharHelpers::isUpperCase ('1'));
+    ASSERT_EQ (CharHelpers::toUpperCase ('['), '[');
+    ASSERT_EQ (CharHelpers::toLowerCase ('@'), '@');
+}
+
+TEST_F (StringHelpersTest, NumberFormattingMatchesStandardLibrary)
+{
+    char buffer[64];
+    auto written = [&buffer] (int numChars) { return std::string (buffer, (std::size_t) numChars); };
+
+    std::uint64_t random = 12345;
+    auto nextRandom = [&random] { random ^= random << 13; random ^= random >> 7; random ^= random << 17; return random; };
+
+    for (auto round = 0; round < 5000; ++round)
+    {
+        auto value = nextRandom() >> (nextRandom() % 64);
+        auto asSigned = static_cast<std::int64_t> (value);
+
+        ASSERT_EQ (written (NumberFormatting::writeInteger (buffer, value)), std::to_string (value));
+        ASSERT_EQ (written (NumberFormatting::writeInteger (buffer, asSigned)), std::to_string (asSigned));
+        ASSERT_EQ (written (NumberFormatting::writeInteger (buffer, static_cast<int> (value))), std::to_string (static_cast<int> (value)));
+
+        double number;
+        memcpy (&number, &value, sizeof (number));
+
+        if (std::isfinite (number))
+        {
+            buffer[NumberFormatting::writeDouble (buffer, number)] = '\0';
+            ASSERT_EQ (std::strtod (buffer, nullptr), number);
+        }
+    }
+
+    ASSERT_EQ (written (NumberFormatting::writeInteger (buffer, std::numeric_limits<std::int64_t>::min())), "-9223372036854775808");
+    ASSERT_EQ (written (NumberFormatting::writeInteger (buffer, std::numeric_limits<std::uint64_t>::max())), "18446744073709551615");
+    ASSERT_EQ (written (NumberFormatting::writeInteger (buffer, 0)), "0");
+    ASSERT_EQ (written (NumberFormatting::writeInteger (buffer, 255, true)), "0xff");
+    ASSERT_EQ (written (NumberFormatting::writeInteger (buffer, -1, true)), "0xffffffff");
+    ASSERT_EQ (written (NumberFormatting::writeInteger (buffer, 0, true)), "0x0");
+
+    ASSERT_EQ (written (NumberFormatting::writeDouble (buffer, 0.1)), "0.1");
+    ASSERT_EQ (written (NumberFormatting::writeDouble (buffer, -2.5e-300)), "-2.5e-300");
+    ASSERT_EQ (written (NumberFormatting::writeDouble (buffer, 3.14159, false, 2)), "3.14");
+    ASSERT_EQ (written (NumberFormatting::writeDouble (buffer, 1234.5, true, 3)), "1.234e+03");
+    ASSERT_EQ (written (NumberFormatting::writeDouble (buffer, -std::numeric_limits<double>::infinity())), "-inf");
+}
+
+TEST_F (StringHelpersTest, NumberParsingMatchesStandardLibrary)
+{
+    std::uint64_t random = 98765;
+    auto nextRandom = [&random] { random ^= random << 13; random ^= random >> 7; random ^= random << 17; return random; };
+    char buffer[64];
+
+    for (auto round = 0; round < 5000; ++round)
+    {
+        auto value = static_cast<std::int64_t> (nextRandom() >> (nextRandom() % 64));
+        value = nextRandom() % 2 == 0 ? -value : value;
+        auto text = std::to_string (value) + (round % 3 == 0 ? " tail" : "");
+
+        auto parsed = NumberParsing::parse<std::int64_t> (text.data(), (int) text.size());
+        ASSERT_TRUE (parsed);
+        ASSERT_EQ (parsed.value, value);
+        ASSERT_EQ (parsed.numCharsConsumed, (int) std::to_string (value).size());
+
+        auto asInt = NumberParsing::parse<int> (text.data(), (int) text.size());
+        auto fitsInt = value >= std::numeric_limits<int>::min() && value <= std::numeric_limits<int>::max();
+        ASSERT_EQ (asInt.error, fitsInt ? ParseError::none : ParseError::outOfRange);
+
+        if (fitsInt)
+        {
+                ASSERT_EQ (asInt.value, value);
+        }
+
+        std::uint64_t bits = nextRandom();
+        double number;
+        memcpy (&number, &bits, sizeof (number));
+
+        if (! std::isfinite (number))
+            continue;
+
+        auto length = round % 2 == 0 ? std::snprintf (buffer, sizeof (buffer), "%.17g", number)
+                                     : std::snprintf (buffer, sizeof (buffer), "%.*f", (int) (nextRandom() % 6), (double) (int) (bits % 100000) / 7.0);
+
+        auto parsedDouble = NumberParsing::parse<double> (buffer, length);
+        ASSERT_TRUE (parsedDouble);
+        ASSERT_EQ (parsedDouble.value, std::strtod (buffer, nullptr)) << buffer;
+        ASSERT_EQ (parsedDouble.numCharsConsumed, length);
+
+        auto parsedFloat = NumberParsing::parse<float> (buffer, length);
+
+        if (parsedFloat)
+        {
+                ASSERT_EQ (parsedFloat.value, std::strtof (buffer, nullptr)) << buffer;
+        }
+    }
+
+    auto parse = [] (const char* text) { return NumberParsing::parse<std::int64_t> (text, StringHelpers::stringLength (text)); };
+
+    ASSERT_EQ (parse ("  +42abc").value, 42);
+    ASSERT_EQ (parse ("  +42abc").numCharsConsumed, 5);
+    ASSERT_EQ (parse ("-9223372036854775808").value, std::numeric_limits<std::int64_t>::min());
+    ASSERT_EQ (parse ("9223372036854775808").error, ParseError::outOfRange);
+    ASSERT_EQ (parse ("99999999999999999999999").value, std::numeric_limits<std::int64_t>::max());
+    ASSERT_EQ (parse ("abc").error, ParseError::noDigits);
+    ASSERT_EQ (parse ("-").error, ParseError::noDigits);
+    ASSERT_EQ (parse ("").error, ParseError::noDigits);
+
+    ASSERT_EQ (NumberParsing::parse<std::uint64_t> ("18446744073709551615", 20).value, std::numeric_limits<std::uint64_t>::max());
+    ASSERT_EQ (NumberParsing::parse<std::uint64_t> ("-1", 2).error, ParseError::noDigits);
+    ASSERT_EQ (NumberParsing::parse<int> ("0xff", 4, true).value, 255);
+    ASSERT_EQ (NumberParsing::parse<int> ("FF", 2, true).value, 255);
+    ASSERT_EQ (NumberParsing::parse<int> ("0xg", 3, true).numCharsConsumed, 1);
+
+    ASSERT_EQ (NumberParsing::parse<double> ("1e400", 5).error, ParseError::outOfRange);
+    ASSERT_EQ (NumberParsing::parse<double> ("-inf", 4).value, -std::numeric_limits<double>::infinity());
+    ASSERT_EQ (NumberParsing::parse<double> ("1.5e", 4).numCharsConsumed, 3);
+    ASSERT_EQ (NumberParsing::parse<double> (".5", 2).value, 0.5);
+    ASSERT_EQ (NumberParsing::parse<double> (".", 1).error, ParseError::noDigits);
+    ASSERT_EQ (NumberParsing::parse<double> ("0.000000000000000000000000123456789012345678901", 47).value, 1.23456789012345678901e-25);
+}
+
 // ===============================================================================================
 
 class StringTest   : public testing::Test
 {
+public:
     StringTest() = default;
     void SetUp() override {}
     void TearDown() override {}
+
+    static bool isStoredInline (const String& string)
+    {
+        auto* object = reinterpret_cast<const char*> (&string);
+        return string.toRawUTF8() >= object && string.toRawUTF8() < object + sizeof (String);
+    }
 };
 
+
+TEST_F (StringTest, SmallStringsAreStoredInline)
+{
+    ASSERT_TRUE (isStoredInline (String()));
+    ASSERT_TRUE (isStoredInline (String ('x')));
+    ASSERT_TRUE (isStoredInline (String (12345)));
+    ASSERT_TRUE (isStoredInline ("short key"_s));
+    ASSERT_FALSE (isStoredInline ("this one is too long to be stored inline"_s));
+
+    auto s = "hello"_s;
+    s.append (", world").toUpperCase();
+    ASSERT_TRUE (isStoredInline (s));
+    ASSERT_EQ (s, "HELLO, WORLD");
+
+    s.append (" and everyone else");
+    ASSERT_FALSE (isStoredInline (s));
+    ASSERT_EQ (s, "HELLO, WORLD and everyone else");
+}
+
+
+TEST_F (StringTest, CopyAndMoveKeepContents)
+{
+    for (auto* text : { "tiny", "a string that is definitely longer than the local buffer" })
+    {
+        auto original = String (text);
+        auto copy = original;
+        ASSERT_EQ (copy, text);
+
+        auto moved = std::move (copy);
+        ASSERT_EQ (moved, text);
+
+        copy = moved;
+        moved = std::move (original);
+        ASSERT_EQ (copy, text);
+        ASSERT_EQ (moved, text);
+    }
+}
+
+
+TEST_F (StringTest, AppendGrowsGeometrically)
+{
+    auto s = String();
+    auto numReallocations = 0;
+    auto* lastBuffer = s.toRawUTF8();
+
+    for (auto i = 0; i < 10000; ++i)
+    {
+        s += 'x';
+
+        if (s.toRawUTF8() != lastBuffer)
+        {
+            ++numReallocations;
+            lastBuffer = s.toRawUTF8();
+        }
+    }
+
+    ASSERT_EQ (s.length(), 10000);
+    ASSERT_GE (s.getAllocatedSize(), s.length());
+    ASSERT_LT (numReallocations, 30);
+
+    auto self = "abc"_s;
+    self.append (self).append (self).append (self);
+    ASSERT_EQ (self, "abcabcabcabcabcabcabcabc");
+    ASSERT_EQ (self.length(), 24);
+    ASSERT_EQ (self[-1], 'c');
+    ASSERT_EQ (self[0], 'a');
+}
+
+
+TEST_F (StringTest, SearchingOperations)
+{
+    auto s = "the cat sat on the mat"_s;
+    ASSERT_TRUE (s.contains ("mat"));
+    ASSERT_FALSE (s.contains ("dog"_s));
+    ASSERT_EQ (s.indexOfSubString ("the"), 0);
+    ASSERT_EQ (s.indexOfSubString ("the", 1), 15);
+    ASSERT_EQ (s.indexOfSubString ("at"_s, 6), 9);
+    ASSERT_EQ (s.indexOfSubString ("at", 22), -1);
+
+    auto fields = "a::b::::c"_s.split ("::"_s);
+    ASSERT_EQ (fields.getNumItems(), 4);
+    ASSERT_EQ (fields[1], "b");
+    ASSERT_EQ (fields[2], "");
+    ASSERT_EQ (fields[3], "c");
+    ASSERT_EQ ("abc"_s.split (""_s).getNumItems(), 1);
+}
+
+
+TEST_F (StringTest, CaseInsensitiveOperations)
+{
+    auto header = "Content-Type: application/JSON; charset=UTF-8"_s;
+    ASSERT_TRUE (header.containsIgnoreCase ("CONTENT-type"));
+    ASSERT_TRUE (header.containsIgnoreCase ("utf-8"_s));
+    ASSERT_FALSE (header.containsIgnoreCase ("xml"));
+    ASSERT_TRUE ("Keep-Alive"_s.equalsIgnoreCase ("keep-alive"));
+    ASSERT_FALSE ("Keep-Alive"_s.equalsIgnoreCase ("keep-alive!"_s));
+    ASSERT_EQ ("abc"_s.compareIgnoreCase ("ABD"), -1);
+    ASSERT_EQ ("abcd"_s.compareIgnoreCase ("ABC"_s), 1);
+}
+
+
+TEST_F (StringTest, CaseConversion)
+{
+    auto identifier = "Some_Mixed_Case_Identifier_With_Digits_0123456789_And_More_Text"_s;
+    auto expectedLower = std::string (identifier.toRawUTF8());
+    auto expectedUpper = expectedLower;
+
+    for (auto& c : expectedLower) c = (char) std::tolower (c);
+    for (auto& c : expectedUpper) c = (char) std::toupper (c);
+
+    ASSERT_EQ (identifier.lowerCased(), expectedLower.c_str());
+    ASSERT_EQ (identifier.upperCased(), expectedUpper.c_str());
+    ASSERT_EQ (String (identifier).toLowerCase(), expectedLower.c_str());
+
+    auto* buffer = identifier.toRawUTF8();
+    auto lowered = std::move (identifier).lowerCased();
+    ASSERT_EQ (lowered.toRawUTF8(), buffer);
+    ASSERT_EQ (lowered, expectedLower.c_str());
+    ASSERT_EQ (std::move (lowered).upperCased(), expectedUpper.c_str());
+}
+
+
+TEST_F (StringTest, ReplaceAll)
+{
+    auto shrinking = "a-b--c---d"_s;
+    auto* buffer = shrinking.toRawUTF8();
+    ASSERT_EQ (shrinking.replaceAll ("--", "+"), "a-b+c+-d");
+    ASSERT_EQ (shrinking.toRawUTF8(), buffer);
+
+    ASSERT_EQ ("x.y.z"_s.replaceAll (".", ""), "xyz");
+    ASSERT_EQ ("aaaa"_s.replaceAll ("aa", "b"), "bb");
+    ASSERT_EQ ("{name} and {name}"_s.replaceAll ("{name}", "Hosa the header only library"),
+               "Hosa the header only library and Hosa the header only library");
+    ASSERT_EQ ("nothing to see"_s.replaceAll ("xyz", "abc"), "nothing to see");
+    ASSERT_EQ ("abc"_s.replaceAll ("", "x"), "abc");
+
+    auto original = "<b>bold</b> and <b>more</b>"_s;
+    ASSERT_EQ (original.replacedAll ("<b>"_s, "**"_s).replacedAll ("</b>"_s, "**"_s), "**bold** and **more**");
+    ASSERT_EQ (original, "<b>bold</b> and <b>more</b>");
+}
+
+
+TEST_F (StringTest, FormatWithMixedArguments)
+{
+    auto name = "Hosa"_s;
+    ASSERT_EQ ("{} has {} parts, {} {}{}"_s.format (name, 2, "a string", 'X', 1.5), "Hosa has 2 parts, a string X1.5");
+    ASSERT_EQ ("{}{}"_s.formatted ("{}", "x"), "{}x");
+    ASSERT_EQ ("only {} place"_s.formatted (1, 2, 3), "only 1 place");
+    ASSERT_EQ ("{} and {}"_s.formatted ("one"), "one and {}");
+    ASSERT_EQ ("no places"_s.formatted(), "no places");
+
+    auto pattern = "{}: {}"_s;
+    ASSERT_EQ (pattern.formatted (pattern, -7), "{}: {}: -7");
+    ASSERT_EQ (pattern, "{}: {}");
+
+    auto* formatted = StringHelpers::format ("{} = {}", "answer", 42);
+    ASSERT_EQ (String (formatted), "answer = 42");
+    delete[] formatted;
+}
+
+
+TEST_F (StringTest, CompileTimeFormatStrings)
+{
+    using Pattern = decltype ("[{}] {} took {} ms"_fmt);
+    static_assert (Pattern::numPlaces == 3);
+    static_assert (Pattern::numLiteralChars == 12);
+
+    ASSERT_EQ ("[{}] {} took {} ms"_fmt.format ('I', "parsing"_s, 12.5), "[I] parsing took 12.5 ms");
+    ASSERT_EQ ("{}{}"_fmt.format (1, 2), "12");
+    ASSERT_EQ ("no places"_fmt.format(), "no places");
+    ASSERT_EQ (""_fmt.format(), "");
+    ASSERT_EQ ("{ } {}"_fmt.format ("x"), "{ } x");
+}
+
+
+TEST_F (StringTest, NumberConversion)
+{
+    ASSERT_EQ (String (42), "42");
+    ASSERT_EQ (String (-7), "-7");
+    ASSERT_EQ (String (255, true), "0xff");
+    ASSERT_EQ (String (std::numeric_limits<std::int64_t>::min()), "-9223372036854775808");
+    ASSERT_EQ (String (std::numeric_limits<std::uint64_t>::max()), "18446744073709551615");
+    ASSERT_EQ (String (0.1), "0.1");
+    ASSERT_EQ (String (1.0 / 3.0), "0.3333333333333333");
+    ASSERT_EQ (String (2.0 / 3.0, false, 3), "0.667");
+    ASSERT_EQ (String (1.5e100, false, 1).length(), 103);
+    ASSERT_TRUE (isStoredInline (String (2.2250738585072014e-308)));
+
+    auto text = "n="_s;
+    text += 10;
+    text.append (std::uint64_t (1) << 40).append (',').append (0.25).append (-1.0, true, 2);
+    ASSERT_EQ (text, "n=101099511627776,0.25-1.00e+00");
+
+    text = 12345678901234LL;
+    ASSERT_EQ (text, "12345678901234");
+    ASSERT_EQ ("{} {}"_s.formatted (std::int64_t (-5000000000), 2.5f), "-5000000000 2.5");
+}
+
+
+#if defined (__SIZEOF_INT128__)
+TEST_F (StringTest, WideIntegersAreNotTruncated)
+{
+    __extension__ using Int128 = __int128;
+    __extension__ using UInt128 = unsigned __int128;
+
+    // only compilers in GNU mode treat these as integral types
+    if constexpr (std::is_integral_v<Int128>)
+    {
+        auto big = (Int128) 1 << 100;
+        ASSERT_EQ (String (big), "1267650600228229401496703205376");
+        ASSERT_EQ ("{}"_s.formatted (-big), "-1267650600228229401496703205376");
+        ASSERT_EQ (String (std::numeric_limits<Int128>::min()), "-170141183460469231731687303715884105728");
+        ASSERT_EQ (String (~UInt128 (0)), "340282366920938463463374607431768211455");
+        ASSERT_EQ (String (big + 5, true), "0x10000000000000000000000005");
+        ASSERT_EQ (String ((UInt128) 10000000000000000000ull * 10), "100000000000000000000");
+
+        auto builder = StringBuilder();
+        builder << big << ' ' << (Int128) 42;
+        ASSERT_EQ (builder.view(), "1267650600228229401496703205376 42");
+    }
+}
+#endif
+
+
+TEST_F (StringTest, BoolsAreWrittenAsNumbers)
+{
+    ASSERT_EQ (String (true), "1");
+    ASSERT_EQ (String (false), "0");
+
+    auto text = "b="_s;
+    text += true;
+    text.append (false);
+    ASSERT_EQ (text, "b=10");
+
+    ASSERT_EQ ("{}{}"_s.formatted (false, true), "01");
+    ASSERT_EQ ("{}"_fmt.format (true), "1");
+
+    auto builder = StringBuilder();
+    builder << true << false;
+    builder.append (true);
+    ASSERT_EQ (builder.view(), "101");
+}
+
+
+TEST_F (StringTest, NumberParsing)
+{
+    ASSERT_EQ ("  123 apples"_s.toInt(), 123);
+    ASSERT_EQ ("0x1f"_s.toInt (true), 31);
+    ASSERT_EQ ("apples"_s.toInt(), 0);
+    ASSERT_EQ ("-2.5e3"_s.toDouble(), -2500.0);
+    ASSERT_EQ ((double) "0.1"_s, 0.1);
+
+    auto result = "12345678901234 rest"_s.parse<std::int64_t>();
+    ASSERT_TRUE (result);
+    ASSERT_EQ (result.value, 12345678901234);
+    ASSERT_EQ (result.numCharsConsumed, 14);
+
+    ASSERT_EQ ("3000000000"_s.parse<int>().error, ParseError::outOfRange);
+    ASSERT_EQ ("3000000000"_s.parse<std::uint32_t>().value, 3000000000u);
+    ASSERT_EQ ("1.25"_s.parse<float>().value, 1.25f);
+    ASSERT_FALSE ("x1"_s.parse<double>());
+    ASSERT_EQ (String (0.1 + 0.2).toDouble(), 0.1 + 0.2);
+}
+
+
+TEST_F (StringTest, StringViews)
+{
+    auto line = "  name = hosa ;  version=2 ; ;  "_s;
+    auto parts = line.splitViews (";");
+
+    ASSERT_EQ (parts.getNumItems(), 4);
+    ASSERT_EQ (parts[0], "name = hosa");
+    ASSERT_EQ (parts[1], "version=2");
+    ASSERT_TRUE (parts[2].isEmpty());
+    ASSERT_EQ (parts[0].data(), line.toRawUTF8() + 2);
+
+    auto key = parts[1].substring (0, parts[1].indexOfChar ('='));
+    auto value = parts[1].substring (parts[1].indexOfChar ('=') + 1, 100);
+    ASSERT_EQ (key, "version");
+    ASSERT_EQ (value.toInt(), 2);
+    ASSERT_EQ (String (key) + "!"_s, "version!");
+
+    auto view = line.trimmedView();
+    ASSERT_TRUE (view.startsWith ("name"));
+    ASSERT_TRUE (view.endsWith ("; ;"));
+    ASSERT_TRUE (view.contains ("hosa"));
+    ASSERT_TRUE (view.containsIgnoreCase ("VERSION"));
+    ASSERT_EQ (view.indexOfSubString ("version"), 15);
+    ASSERT_EQ (view.indexOfSubString ("version", 16), -1);
+    ASSERT_EQ (view[-1], ';');
+
+    ASSERT_TRUE (StringView ("abc") < StringView ("abd"));
+    ASSERT_EQ (StringView ("HoSa").compareIgnoreCase ("hosa"), 0);
+    ASSERT_EQ (StringView ("hosa").hash(), "hosa"_s.view().hash());
+    ASSERT_NE (StringView ("hosa").hash(), StringView ("asoh").hash());
+    ASSERT_EQ (StringView ("2.5e1").parse<double>().value, 25.0);
+    ASSERT_EQ (line.substringView (2, 4), "name");
+    ASSERT_EQ (line.substringView (30, 10), "  ");
+    ASSERT_TRUE (line.startsWith ("  na"));
+    ASSERT_FALSE (line.endsWith ("x"));
+
+    auto text = "id:"_s;
+    text += key;
+    ASSERT_EQ (text, "id:version");
+    ASSERT_EQ ("{}={}"_s.formatted (key, value), "version=2");
+
+    std::stringstream stream;
+    stream << key;
+    ASSERT_EQ (stream.str(), "version");
+}
+
+
+TEST_F (StringTest, LazySplitting)
+{
+    auto line = "a, b,,  c ,d"_s;
+    auto collect = [] (const StringTokenizer& tokenizer)
+    {
+        auto parts = std::vector<std::string>();
+
+        for (auto part : tokenizer)
+            parts.emplace_back (part.data(), (std::size_t) part.length());
+
+        return parts;
+    };
+
+    using Parts = std::vector<std::string>;
+    ASSERT_EQ (collect (line.splitLazy (",")), (Parts { "a", "b", "", "c", "d" }));
+    ASSERT_EQ (collect (line.splitLazy (",", false)), (Parts { "a", " b", "", "  c ", "d" }));
+    ASSERT_EQ (collect (line.splitLazy (",").skippingEmpty()), (Parts { "a", "b", "c", "d" }));
+    ASSERT_EQ (collect (line.splitLazy (",").withMaxSplits (2)), (Parts { "a", "b", ",  c ,d" }));
+    ASSERT_EQ (collect (tokenize ("x--y--", "--")), (Parts { "x", "y", "" }));
+    ASSERT_EQ (collect (tokenize ("x--y--", "--").skippingEmpty()), (Parts { "x", "y" }));
+    ASSERT_EQ (collect (tokenize ("", ",")), (Parts { "" }));
+    ASSERT_EQ (collect (tokenize ("", ",").skippingEmpty()), Parts());
+    ASSERT_EQ (collect (tokenize ("abc", "")), (Parts { "abc" }));
+
+    auto fields = line.splitLazy (",");
+    auto second = std::next (fields.begin());
+    ASSERT_EQ (*second, "b");
+    ASSERT_EQ (second->data(), line.toRawUTF8() + 3);
+
+    ASSERT_EQ (line.split (",").getNumItems(), 5);
+    ASSERT_EQ (line.split (",")[3], "c");
+    ASSERT_EQ ("no separator "_s.split (",")[0], "no separator ");
+}
+
+
+TEST_F (StringTest, ChainedConcatenation)
+{
+    auto prefix = "user:"_s;
+    auto key = "some-rather-long-key"_s;
+    StringView value = "value";
+
+    String joined = prefix + key + ':' + value + " #" + 42 + '/' + 0.5;
+    ASSERT_EQ (joined, "user:some-rather-long-key:value #42/0.5");
+    ASSERT_EQ (joined.getAllocatedSize(), joined.length());
+
+    ASSERT_EQ ("a"_s + "b", "ab");
+    ASSERT_EQ ("a" + "b"_s + String ("c"), "abc");
+    ASSERT_EQ (1 + "x"_s + std::int64_t (-2), "1x-2");
+    ASSERT_EQ ((prefix + key).length(), 25);
+
+    auto text = "start "_s;
+    text += prefix + key;
+    text.append (text + '!' + text);
+    ASSERT_EQ (text, "start user:some-rather-long-keystart user:some-rather-long-key!start user:some-rather-long-key");
+
+    auto small = "ab"_s;
+    small.ensureAllocatedSpace (10);
+    small += small + small;
+    ASSERT_EQ (small, "ababab");
+
+    auto* literal = "pointer";
+    ASSERT_EQ (String (literal + 3), "nter");
+
+    std::stringstream stream;
+    stream << prefix + 7;
+    ASSERT_EQ (stream.str(), "user:7");
+}
+
+
+TEST_F (StringTest, StringBuilderReusesItsBuffer)
+{
+    auto builder = StringBuilder (8);
+    builder << "id=" << 42 << ' ' << "name"_s << StringView ("=x");
+    builder.append (255, true).append (',').append (2.0 / 3.0, false, 2);
+    ASSERT_EQ (builder.view(), "id=42 name=x0xff,0.67");
+
+    builder.appendFormat (" [{}:{}]", "k", -1.5);
+    ASSERT_EQ (builder.toString(), "id=42 name=x0xff,0.67 [k:-1.5]");
+
+    // heap text is handed over as it is
+    auto capacity = builder.getCapacity();
+    auto* bufferStart = builder.view().data();
+    auto released = builder.release();
+    ASSERT_EQ (released, "id=42 name=x0xff,0.67 [k:-1.5]");
+    ASSERT_EQ (released.toRawUTF8(), bufferStart);
+    ASSERT_EQ (released.getAllocatedSize(), capacity);
+    ASSERT_TRUE (builder.isEmpty());
+    ASSERT_EQ (builder.getCapacity(), 0);
+
+    // short text gets copied, and the builder keeps its buffer
+    builder.reserve (100);
+    builder << "short";
+    auto shortString = builder.release();
+    ASSERT_EQ (shortString, "short");
+    ASSERT_TRUE (isStoredInline (shortString));
+    ASSERT_EQ (builder.getCapacity(), 100);
+
+    for (auto i = 0; i < 1000; ++i)
+    {
+        builder.clear();
+        builder << "line " << i;
+    }
+
+    ASSERT_EQ (builder.view(), "line 999");
+    ASSERT_EQ (builder.getCapacity(), 100);
+
+    ASSERT_EQ (String::joinFromArray (Array<String> ("a"_s, "b"_s, "c"_s), ", "_s), "a, b, c");
+    ASSERT_EQ (String::joinFromArray (Array<String>(), ", "_s), "");
+    ASSERT_EQ ("ab"_s * 3, "ababab");
+    ASSERT_EQ ("ab"_s * 0, "");
+
+    auto repeated = "xyz"_s;
+    repeated *= 10;
+    ASSERT_EQ (repeated.length(), 30);
+    ASSERT_EQ (repeated.getAllocatedSize(), 30);
+}
+
+
+TEST_F (StringTest, RopeEditsMatchString)
+{
+    auto random = 4321u;
+    auto nextRandom = [&random] { random = random * 1103515245u + 12345u; return (int) ((random >> 16) & 0x7fff); };
+
+    auto text = std::string();
+
+    for (auto i = 0; i < 5000; ++i)
+        text += (char) ('a' + nextRandom() % 4);
+
+    auto rope = Rope (StringView (text.data(), (int) text.size()));
+    auto original = rope;
+    auto originalText = text;
+    ASSERT_EQ (rope.getNumChunks(), 5);
+
+    for (auto round = 0; round < 3000; ++round)
+    {
+        auto index = nextRandom() % ((int) text.size() + 1);
+        auto numChars = nextRandom() % 50;
+        auto inserted = std::string (1 + nextRandom() % 20, (char) ('a' + nextRandom() % 4));
+
+        switch (nextRandom() % 3)
+        {
+            case 0:
+                rope.insert (StringView (inserted.data(), (int) inserted.size()), index);
+                text.insert ((std::size_t) index, inserted);
+                break;
+            case 1:
+                rope.remove (index, numChars);
+                text.erase ((std::size_t) index, (std::size_t) numChars);
+                break;
+            default:
+                rope.append (StringView (inserted.data(), (int) inserted.size()));
+                text += inserted;
+                break;
+        }
+
+        auto needle = text.substr ((std::size_t) (nextRandom() % ((int) text.size() + 1)), 1 + (std::size_t) (nextRandom() % 6));
+        auto from = nextRandom() % ((int) text.size() + 1);
+        auto expected = text.find (needle, (std::size_t) from);
+
+        ASSERT_EQ (rope.indexOfSubString (StringView (needle.data(), (int) needle.size()), from),
+                   expected == std::string::npos ? -1 : (int) expected) << needle << " from " << from;
+        ASSERT_EQ (rope[index < (int) text.size() ? index : 0], text[index < (int) text.size() ? (std::size_t) index : 0]);
+    }
+
+    ASSERT_EQ (rope.length(), (int) text.size());
+    ASSERT_TRUE (rope == StringView (text.data(), (int) text.size()));
+    ASSERT_EQ (rope.toString(), text.c_str());
+    ASSERT_LE (rope.getHeight(), 20);
+
+    // edits never change the Ropes they were made from
+    ASSERT_TRUE (original == StringView (originalText.data(), (int) originalText.size()));
+
+    auto chunks = std::string();
+    rope.forEachChunk ([&chunks] (StringView chunk) { chunks.append (chunk.data(), (std::size_t) chunk.length()); });
+    ASSERT_EQ (chunks, text);
+
+    ASSERT_EQ (Rope ("dogs are better than cats"_s).swap ("dogs", "cats"), "cats are better than dogs");
+    ASSERT_EQ (Rope ("one two"_s).swap ("one", "three"), "one two");
+    ASSERT_EQ (Rope ("Hosa is hard"_s).replace ("hard", "easy"), "Hosa is easy");
+    ASSERT_EQ (Rope ("a-b-c"_s).replaceAll ("-", "--"), "a--b--c");
+    ASSERT_EQ (Rope ("world"_s).prepend ("hello "), "hello world");
+    ASSERT_EQ (Rope ("held"_s).insert ("llo wor", 2), "hello world");
+    ASSERT_EQ (Rope ("hello world"_s).remove (" world"), "hello");
+    ASSERT_EQ (Rope ("hello world"_s).remove (2, 100), "he");
+    ASSERT_EQ (Rope ("hello world"_s).substring (6, 100), "world");
+    ASSERT_EQ (Rope ("hello"_s)[-1], 'o');
+    ASSERT_TRUE (Rope().isEmpty());
+    ASSERT_EQ (Rope().toString(), "");
+}
+
+
+TEST_F (StringTest, SharedStringCopiesOnWrite)
+{
+    auto original = SharedString ("route: /api/v1/users"_s);
+    ASSERT_EQ (original.getReferenceCount(), 1);
+
+    auto table = Array<SharedString>();
+
+    for (auto i = 0; i < 100; ++i)
+        table.add (original);
+
+    auto copiedTable = table;
+    ASSERT_EQ (original.getReferenceCount(), 201);
+    ASSERT_EQ (copiedTable[50].data(), original.data());
+    ASSERT_TRUE (copiedTable[99] == original);
+
+    // changing one copy leaves the others alone
+    auto changed = original;
+    changed += " (deprecated)";
+    ASSERT_EQ (changed, "route: /api/v1/users (deprecated)");
+    ASSERT_EQ (original, "route: /api/v1/users");
+    ASSERT_EQ (original.getReferenceCount(), 201);
+    ASSERT_FALSE (changed.isShared());
+
+    // one that isn't shared grows in place when it can, also when appending a part of itself
+    auto* before = changed.data();
+    changed.append (changed.view().substring (0, 5));
+    ASSERT_EQ (changed, "route: /api/v1/users (deprecated)route");
+    ASSERT_EQ (changed.data(), before);
+
+    for (auto i = 0; i < 3; ++i)
+        changed.append (changed);
+
+    ASSERT_EQ (changed.length(), 38 * 8);
+    ASSERT_EQ (changed.view().substring (38 * 7, 38), "route: /api/v1/users (deprecated)route");
+
+    auto upper = copiedTable[0];
+    upper.getWritableData()[0] = 'R';
+    ASSERT_EQ (upper, "Route: /api/v1/users");
+    ASSERT_EQ (copiedTable[0], "route: /api/v1/users");
+
+    table.clear();
+    copiedTable.clear();
+    ASSERT_EQ (original.getReferenceCount(), 1);
+
+    auto empty = SharedString();
+    ASSERT_TRUE (empty.isEmpty());
+    ASSERT_EQ (empty.toRawUTF8(), StringView (""));
+    ASSERT_EQ (empty.getReferenceCount(), 0);
+    empty = StringView ("not anymore");
+    ASSERT_EQ (String (empty), "not anymore");
+
+    // they can be formatted like Strings
+    auto shared = SharedString ("/health"_s);
+    ASSERT_EQ ("GET {} {}"_s.formatted (shared, empty), "GET /health not anymore");
+    ASSERT_EQ (StringBuilder().appendFormat ("[{}]", shared).view(), "[/health]");
+}
+
+
+TEST_F (StringTest, InternedStringsCompareByIdentity)
+{
+    auto pool = StringPool();
+
+    auto cpu = pool.intern ("cpu.usage");
+    auto memory = pool.intern ("memory.usage");
+    auto* text = "cpu.usage";
+
+    ASSERT_EQ (pool.intern (StringView (text, 9)), cpu);
+    ASSERT_EQ (pool.intern ("cpu.usage"_s), cpu);
+    ASSERT_EQ (pool.intern ("cpu.usage.total"_s.substringView (0, 9)), cpu);
+    ASSERT_NE (cpu, memory);
+    ASSERT_EQ (cpu.view(), "cpu.usage");
+    ASSERT_EQ (std::string (cpu.toRawUTF8()), "cpu.usage");
+    ASSERT_EQ (cpu.hash(), StringView ("cpu.usage").hash());
+    ASSERT_EQ (std::hash<InternedString>() (cpu), (std::size_t) cpu.hash());
+    ASSERT_EQ (pool.intern (""), InternedString());
+    ASSERT_EQ (pool.find ("disk.usage"), InternedString());
+    ASSERT_EQ (pool.find ("memory.usage"), memory);
+    ASSERT_EQ (pool.getNumStrings(), 2);
+
+    // they can be formatted like Strings
+    ASSERT_EQ ("{} < {}"_s.formatted (cpu, pool.intern ("memory.usage")), "cpu.usage < memory.usage");
+    ASSERT_EQ ("{}"_fmt.format (memory), "memory.usage");
+    ASSERT_EQ (StringBuilder().appendFormat ("<{}>", memory).view(), "<memory.usage>");
+
+    // many threads interning the same names all get the same handles
+    auto names = Array<String>();
+
+    for (auto i = 0; i < 2000; ++i)
+        names.add ("metric."_s + i % 500);
+
+    auto results = std::vector<Array<InternedString>> (4);
+    auto threads = std::vector<std::thread>();
+
+    for (auto t = 0; t < 4; ++t)
+        threads.emplace_back ([&, t] { results[(std::size_t) t] = pool.internAll (names); });
+
+    for (auto& thread : threads)
+        thread.join();
+
+    ASSERT_EQ (pool.getNumStrings(), 502);
+
+    for (auto i = 0; i < names.getNumItems(); ++i)
+    {
+        ASSERT_EQ (results[0][i].view(), names[i]);
+        ASSERT_EQ (results[1][i], results[0][i]);
+        ASSERT_EQ (results[3][i], results[0][i % 500]);
+        ASSERT_EQ (pool.intern (names[i]), results[2][i]);
+    }
+
+    // texts bigger than an arena chunk get one of their own
+    auto huge = String ("x") * 100000;
+    ASSERT_EQ (pool.intern (huge).view(), huge);
+    ASSERT_EQ (pool.intern (huge), pool.intern (huge));
+
+    ASSERT_EQ (StringPool::getGlobalPool().intern ("global"), StringPool::getGlobalPool().intern ("global"_s));
+}
+
+
+TEST_F (StringTest, UTF8ValidationAndCodepoints)
+{
+    auto text = "h\xc3\xa9llo \xe2\x82\xac \xf0\x9f\x98\x80!"_s;   // "héllo € 😀!"
+    ASSERT_TRUE (text.isValidUTF8());
+    ASSERT_EQ (text.length(), 16);
+    ASSERT_EQ (text.codepointLength(), 10);
+
+    auto decoded = std::vector<char32_t>();
+
+    for (auto codepoint : text.codepoints())
+        decoded.push_back (codepoint);
+
+    ASSERT_EQ (decoded, (std::vector<char32_t> { 'h', 0xe9, 'l', 'l', 'o', ' ', 0x20ac, ' ', 0x1f600, '!' }));
+    ASSERT_EQ (text.reversed(), "!\xf0\x9f\x98\x80 \xe2\x82\xac oll\xc3\xa9h");
+    ASSERT_TRUE (text.reversed().isValidUTF8());
+    ASSERT_EQ (text.reversed().reversed(), text);
+
+    for (auto invalid : { "\xc0\x80", "\xed\xa0\x80", "\xf4\x90\x80\x80", "\xe2\x82", "\x80", "a\xff", "\xf8\x88\x80\x80\x80" })
+        ASSERT_FALSE (StringView (invalid).isValidUTF8()) << invalid;
+
+    // invalid bytes are decoded (and reversed) one at a time
+    ASSERT_EQ (StringView ("a\xe2\x82").codepointLength(), 2);
+    ASSERT_EQ (*StringView ("\xe2\x82").codepoints().begin(), UTF8::replacementCharacter);
+    ASSERT_EQ ("\x80" "a\xc3\xa9"_s.reversed(), "\xc3\xa9" "a\x80");
+
+    // the vectorised validator has to agree with the scalar one, also around block boundaries
+    auto random = 12345u;
+    auto next = [&random] { random = random * 1103515245u + 12345u; return random >> 8; };
+    auto encode = [] (std::string& out, char32_t c)
+    {
+        if (c < 0x80)         out += (char) c;
+        else if (c < 0x800)   { out += (char) (0xc0 | (c >> 6)); out += (char) (0x80 | (c & 0x3f)); }
+        else if (c < 0x10000) { out += (char) (0xe0 | (c >> 12)); out += (char) (0x80 | ((c >> 6) & 0x3f)); out += (char) (0x80 | (c & 0x3f)); }
+        else                  { out += (char) (0xf0 | (c >> 18)); out += (char) (0x80 | ((c >> 12) & 0x3f));
+                                out += (char) (0x80 | ((c >> 6) & 0x3f)); out += (char) (0x80 | (c & 0x3f)); }
+    };
+
+    for (auto round = 0; round < 3000; ++round)
+    {
+        auto codepoints = std::vector<char32_t>();
+        auto bytes = std::string();
+        auto numCodepoints = (int) (next() % 120);
+
+        for (auto i = 0; i < numCodepoints; ++i)
+        {
+            auto kind = next() % 4;
+            auto c = (char32_t) (kind == 0 ? next() % 0x80 : kind == 1 ? 0x80 + next() % 0x780
+                                  : kind == 2 ? 0x800 + next() % 0xf800 : 0x10000 + next() % 0x100000);
+
+            if (c >= 0xd800 && c <= 0xdfff)
+                c = 'x';
+
+            codepoints.push_back (c);
+            encode (bytes, c);
+        }
+
+        auto view = StringView (bytes.data(), (int) bytes.size());
+        ASSERT_TRUE (view.isValidUTF8());
+        ASSERT_EQ (view.codepointLength(), numCodepoints);
+        ASSERT_EQ (std::vector<char32_t> (view.codepoints().begin(), view.codepoints().end()), codepoints);
+
+        auto reversed = String (view).reverse();
+        ASSERT_EQ (std::vector<char32_t> (reversed.codepoints().begin(), reversed.codepoints().end()),
+                   std::vector<char32_t> (codepoints.rbegin(), codepoints.rend()));
+
+        if (! bytes.empty())
+        {
+            for (auto numChanges = next() % 3 + 1; numChanges > 0; --numChanges)
+                bytes[next() % bytes.size()] = (char) next();
+
+            auto mutated = StringView (bytes.data(), (int) bytes.size());
+            ASSERT_EQ (mutated.isValidUTF8(), UTF8::isValidScalar (mutated.data(), mutated.length())) << round;
+            ASSERT_EQ (String (mutated).reversed().length(), mutated.length());
+        }
+    }
+}
+
+
+TEST_F (StringTest, MultiPatternMatching)
+{
+    auto matcher = MultiPatternMatcher { "he", "she", "his", "hers" };
+    auto matches = matcher.findAll ("ushers");
+    ASSERT_EQ (matches.getNumItems(), 3);
+    ASSERT_EQ (matches[0].patternIndex, 1);
+    ASSERT_EQ (matches[0].start, 1);
+    ASSERT_EQ (matches[1].patternIndex, 0);
+    ASSERT_EQ (matches[2].patternIndex, 3);
+    ASSERT_TRUE (matcher.containsAny ("this"));
+    ASSERT_FALSE (matcher.containsAny ("tis"));
+    ASSERT_EQ (matcher.replaceAll ("she said his hers", Array<String> { "HE"_s, "SHE"_s, "HIS"_s, "HERS"_s }), "SHE said HIS HERS");
+    ASSERT_EQ (matcher.replaceAll ("ushers", "*"), "u*rs");
+
+    auto secrets = MultiPatternMatcher (Array<String> { "password"_s, "pass"_s, "token"_s });
+    ASSERT_EQ (secrets.replaceAll ("passport password token", "***"), "***port *** ***");
+    ASSERT_EQ (MultiPatternMatcher().replaceAll ("nothing", "x"), "nothing");
+
+    // against brute force, with a small alphabet so there are lots of overlapping matches
+    auto random = 777u;
+    auto next = [&random] { random = random * 1103515245u + 12345u; return random >> 8; };
+    auto randomText = [&next] (int maxLength)
+    {
+        auto text = String();
+
+        for (auto length = (int) (next() % (unsigned) maxLength); length > 0; --length)
+            text += (char) ('a' + next() % 3);
+
+        return text;
+    };
+
+    for (auto round = 0; round < 500; ++round)
+    {
+        auto patterns = Array<String>();
+        auto replacements = Array<String>();
+
+        for (auto numPatterns = next() % 8 + 1; numPatterns > 0; --numPatterns)
+        {
+            patterns.add (randomText (6));
+            replacements.add (String (round % 7) + "_");
+        }
+
+        auto text = randomText (80);
+        auto patternMatcher = MultiPatternMatcher (patterns);
+
+        auto expected = std::vector<std::tuple<int, int, int>>();   // end, start, first pattern index
+        auto expectedLongest = String();
+
+        for (auto start = 0; start < text.length(); ++start)
+        {
+            for (auto p = 0; p < patterns.getNumItems(); ++p)
+            {
+                auto& pattern = patterns[p];
+                auto isFirst = true;
+
+                for (auto q = 0; q < p; ++q)
+                    isFirst &= patterns[q] != pattern;
+
+                if (isFirst && pattern.length() > 0 && start + pattern.length() <= text.length()
+                     && text.view().substring (start, pattern.length()) == pattern.view())
+                    expected.emplace_back (start + pattern.length(), start, p);
+            }
+        }
+
+        auto found = std::vector<std::tuple<int, int, int>>();
+
+        for (auto& match : patternMatcher.findAll (text))
+            found.emplace_back (match.start + match.length, match.start, match.patternIndex);
+
+        std::sort (expected.begin(), expected.end());
+        std::sort (found.begin(), found.end());
+        ASSERT_EQ (found, expected) << round;
+
+        // replaces greedily from left to right, taking the longest pattern at each position
+        for (auto position = 0; position < text.length();)
+        {
+            auto longest = -1;
+
+            for (auto p = 0; p < patterns.getNumItems(); ++p)
+                if (patterns[p].length() > 0 && position + patterns[p].length() <= text.length()
+                     && text.view().substring (position, patterns[p].length()) == patterns[p].view()
+                     && (longest < 0 || patterns[p].length() > patterns[longest].length()))
+                    longest = p;
+
+            if (longest < 0)
+            {
+                expectedLongest += text[position++];
+            }
+            else
+            {
+                expectedLongest += replacements[longest];
+                position += patterns[longest].length();
+            }
+        }
+
+        ASSERT_EQ (patternMatcher.replaceAll (text, replacements), expectedLongest) << round;
+    }
+}
+
+
+TEST_F (StringTest, GlobPatterns)
+{
+    ASSERT_EQ (GlobPattern ("main.cpp").getShape(), GlobPattern::Shape::literal);
+    ASSERT_EQ (GlobPattern ("api/*").getShape(), GlobPattern::Shape::prefix);
+    ASSERT_EQ (GlobPattern ("*.log").getShape(), GlobPattern::Shape::suffix);
+    ASSERT_EQ (GlobPattern ("**error**").getShape(), GlobPattern::Shape::substring);
+    ASSERT_EQ (GlobPattern ("api/*/v?").getShape(), GlobPattern::Shape::general);
+    ASSERT_EQ (GlobPattern ("\\*.txt").getShape(), GlobPattern::Shape::literal);
+
+    ASSERT_TRUE (GlobPattern ("api/*/v?").matches ("api/users/v2"));
+    ASSERT_FALSE (GlobPattern ("api/*/v?").matches ("api/users/v10"));
+    ASSERT_TRUE (GlobPattern ("*.log").matches (".log"));
+    ASSERT_FALSE (GlobPattern ("*.log").matches ("app.LOG"));
+    ASSERT_TRUE (GlobPattern ("*.log", true).matches ("app.LOG"));
+    ASSERT_TRUE (GlobPattern ("\\*.txt").matches ("*.txt"));
+    ASSERT_FALSE (GlobPattern ("\\*.txt").matches ("a.txt"));
+    ASSERT_TRUE (GlobPattern ("*").matches (""));
+    ASSERT_TRUE (GlobPattern().matches (""));
+    ASSERT_FALSE (GlobPattern().matches ("a"));
+
+    auto files = Array<String> { "app.log"_s, "README.md"_s, "error.LOG"_s, "log.txt"_s };
+    auto logs = GlobPattern ("*.log", true);
+    auto matching = logs.findMatches (files);
+    ASSERT_EQ (matching.getNumItems(), 2);
+    ASSERT_EQ (matching[0], 0);
+    ASSERT_EQ (matching[1], 2);
+    ASSERT_EQ (logs.countMatches (files), 2);
+
+    // against a plain recursive matcher, for all shapes and both cases
+    std::function<bool (const char*, const char*, bool)> reference = [&] (const char* p, const char* t, bool ignoreCase)
+    {
+        if (*p == '\0')
+            return *t == '\0';
+
+        if (*p == '*')
+            return reference (p + 1, t, ignoreCase) || (*t != '\0' && reference (p, t + 1, ignoreCase));
+
+        if (*t == '\0')
+            return false;
+
+        auto c = *p;
+
+        if (c == '\\' && p[1] != '\0')
+            c = *++p;
+        else if (c == '?')
+            return reference (p + 1, t + 1, ignoreCase);
+
+        auto equal = ignoreCase ? CaseConversion::toLowerCase (c) == CaseConversion::toLowerCase (*t) : c == *t;
+        return equal && reference (p + 1, t + 1, ignoreCase);
+    };
+
+    auto random = 4242u;
+    auto next = [&random] { random = random * 1103515245u + 12345u; return random >> 8; };
+    auto randomString = [&next] (const char* alphabet, int alphabetSize, int maxLength)
+    {
+        auto result = std::string();
+
+        for (auto length = (int) (next() % (unsigned) maxLength); length > 0; --length)
+            result += alphabet[next() % (unsigned) alphabetSize];
+
+        return result;
+    };
+
+    for (auto round = 0; round < 3000; ++round)
+    {
+        auto pattern = randomString ("aAb**?\\", 7, 8);
+        auto ignoreCase = round % 2 == 0;
+        auto glob = GlobPattern (StringView (pattern.data(), (int) pattern.size()), ignoreCase);
+
+        for (auto i = 0; i < 10; ++i)
+        {
+            auto text = randomString ("aAb*?\\", 6, 12);
+            ASSERT_EQ (glob.matches (StringView (text.data(), (int) text.size())),
+                       reference (pattern.c_str(), text.c_str(), ignoreCase)) << pattern << " " << text;
+        }
+    }
+
+    // middle parts with ?s that span more than one (and more than 16) words of the shift-and state
+    for (auto partLength : { 63, 64, 65, 200, 1100 })
+    {
+        auto part = std::string ((std::size_t) partLength, 'a');
+        part[10] = part[(std::size_t) partLength - 2] = '?';
+        part.back() = 'B';
+
+        auto text = "x" + std::string (3000, 'a') + std::string ((std::size_t) partLength - 1, 'a') + "bc";
+        auto pattern = "x*" + part + "*c";
+
+        ASSERT_TRUE (GlobPattern (StringView (pattern.data(), (int) pattern.size()), true)
+                        .matches (StringView (text.data(), (int) text.size()))) << partLength;
+        ASSERT_FALSE (GlobPattern (StringView (pattern.data(), (int) pattern.size()))
+                        .matches (StringView (text.data(), (int) text.size()))) << partLength;
+    }
+
+    // long middle parts without ?s, on texts where a plain search would keep almost matching
+    ASSERT_EQ (GlobPattern (("*" + std::string (65, 'a') + "*").c_str()).getShape(), GlobPattern::Shape::general);
+
+    for (auto round = 0; round < 200; ++round)
+    {
+        auto part = randomString ("ab", 2, 150);
+        part.append (65 + next() % 60, 'a');
+        part += randomString ("ab", 2, 4);
+
+        auto text = randomString ("aaaab", 5, 2000);
+        auto pattern = "*" + part + "*";
+        auto ignoreCase = round % 2 == 0;
+
+        if (next() % 2 == 0)
+            text.insert (next() % (text.size() + 1), part);
+
+        auto expected = text.find (part) != std::string::npos;
+
+        if (ignoreCase)
+            for (auto& c : text)
+                c = (char) (next() % 2 == 0 ? c : c - 'a' + 'A');
+
+        auto glob = GlobPattern (StringView (pattern.data(), (int) pattern.size()), ignoreCase);
+        ASSERT_EQ (glob.getShape(), GlobPattern::Shape::general);
+        ASSERT_EQ (glob.matches (StringView (text.data(), (int) text.size())),
+                   ignoreCase ? expected : text.find (part) != std::string::npos) << pattern << " " << text;
+    }
+}
+
+
+TEST_F (StringTest, EditingOperations)
+{
+    ASSERT_EQ ("dogs are better than cats"_s.swap ("dogs", "cats"), "cats are better than dogs");
+    ASSERT_EQ ("one two"_s.swap ("one", "three"), "one two");
+    ASSERT_EQ ("!gnizama si asoH"_s.reverse(), "Hosa is amazing!");
+    ASSERT_EQ ("Hosa is hard"_s.replace ("hard", "easy"), "Hosa is easy");
+    ASSERT_EQ ("world"_s.prepend ("hello "), "hello world");
+    ASSERT_EQ ("held"_s.insert ("llo wor", 2), "hello world");
+    ASSERT_EQ ("hello world"_s.remove (" world"), "hello");
+    ASSERT_EQ ("hello world"_s.remove (2, 100), "he");
+    ASSERT_EQ ("  padded \t"_s.clipOffWhiteSpace(), "padded");
+    ASSERT_EQ ("   "_s.clipOffWhiteSpace(), "");
+    ASSERT_EQ (" a b c "_s.withoutWhiteSpace(), "abc");
+    ASSERT_EQ ("MiXeD"_s.lowerCased(), "mixed");
+    ASSERT_EQ ("MiXeD"_s.upperCased(), "MIXED");
+    ASSERT_EQ ("ab"_s * 3, "ababab");
+    ASSERT_EQ ("value: "_s.append (42), "value: 42");
+    ASSERT_EQ (String (255, true), "0xff");
+
+    auto numbers = "one, two, three"_s.split (","_s);
+    ASSERT_EQ (numbers.getNumItems(), 3);
+    ASSERT_EQ (numbers[2], "three");
+    ASSERT_EQ (String::joinFromArray (numbers, "-"_s), "one-two-three");
+
+    ASSERT_EQ ("{} is very {} to use."_s.format ("Hosa", "easy"), "Hosa is very easy to use.");
+}
+
 // ===============================================================================================
 
 class ArrayTest   : public testing::Test
 {
+public:
     ArrayTest() = default;
     void SetUp() override {}
     void TearDown() override {}
 };
 
+TEST_F (ArrayTest, MemoryResources)
+{
+    auto arena = MonotonicArena (1024);
+
+    {
+        auto fields = Array<String> (arena);
+
+        for (auto i = 0; i < 100; ++i)
+            fields.add (String (String ("a field that is too long to be stored inline #"_s + i), arena));
+
+        ASSERT_EQ (&fields.getMemoryResource(), &arena);
+        ASSERT_EQ (&fields[99].getMemoryResource(), &arena);
+        ASSERT_EQ (fields[99], "a field that is too long to be stored inline #99");
+        ASSERT_GT (arena.getNumBytesAllocated(), (std::size_t) 100 * 48);
+
+        // copies go to the heap, so they can outlive the arena
+        auto copy = fields;
+        ASSERT_EQ (&copy.getMemoryResource(), &getDefaultMemoryResource());
+        ASSERT_EQ (&copy[0].getMemoryResource(), &getDefaultMemoryResource());
+
+        // Strings keep their resource when assigned to, also when growing
+        auto text = String (arena);
+        text = copy[5];
+        text += " and then some more text";
+        text.replaceAll ("e", "EE");
+        ASSERT_EQ (&text.getMemoryResource(), &arena);
+        ASSERT_EQ (text, "a fiEEld that is too long to bEE storEEd inlinEE #5 and thEEn somEE morEE tEExt");
+
+        auto fromHeap = String (copy[1]);
+        fromHeap = std::move (text);
+        ASSERT_EQ (&fromHeap.getMemoryResource(), &getDefaultMemoryResource());
+        ASSERT_EQ (fromHeap.length(), 79);
+    }
+
+    arena.reset();
+    ASSERT_EQ (arena.getNumBytesAllocated(), (std::size_t) 0);
+
+    // the last allocation in an arena grows in place
+    auto numbers = Array<int> (arena);
+    numbers.add (1);
+    auto* first = &numbers[0];
+
+    for (auto i = 0; i < 200; ++i)
+        numbers.add (i);
+
+    ASSERT_EQ (&numbers[0], first);
+    ASSERT_EQ (numbers[200], 199);
+
+    // reset keeps the biggest chunk, also when a later one is smaller
+    auto smallChunks = MonotonicArena (64);
+    auto* big = smallChunks.allocate (10000, 8);
+    smallChunks.allocate (100, 8);
+    smallChunks.reset();
+    ASSERT_EQ (smallChunks.allocate (5000, 8), big);
+
+    auto pool = PoolMemoryResource();
+    auto* small = pool.allocate (24, 8);
+    pool.deallocate (small, 24, 8);
+    ASSERT_EQ (pool.allocate (30, 8), small);
+
+    auto pooled = Array<String> (pool);
+
+    for (auto i = 0; i < 1000; ++i)
+    {
+        pooled.add (String (String ("pooled string number "_s + i + " of many"), pool));
+
+        if (i % 3 == 0)
+            pooled.remove (0);
+    }
+
+    ASSERT_EQ (pooled.getNumItems(), 666);
+    ASSERT_EQ (pooled[665], "pooled string number 999 of many");
+}
+
+// ===============================================================================================
+
+class HashMapTest   : public testing::Test
+{
+public:
+    HashMapTest() = default;
+    void SetUp() override {}
+    void TearDown() override {}
+};
+
+
+TEST_F (HashMapTest, StringTypesHashTheSame)
+{
+    auto pool = StringPool();
+    auto text = "symbol_table_entry"_s;
+
+    ASSERT_EQ (text.hash(), StringView ("symbol_table_entry").hash());
+    ASSERT_EQ (SharedString (text).hash(), text.hash());
+    ASSERT_EQ (pool.intern (text).hash(), text.hash());
+    ASSERT_EQ (std::hash<String>() (text), std::hash<StringView>() (text));
+    ASSERT_NE ("a"_s.hash(), "b"_s.hash());
+    ASSERT_NE (""_s.hash(), String ("\0", 1).hash());
+    ASSERT_EQ (text.toStdString(), "symbol_table_entry");
+
+    // every length takes a slightly different path, and all bits of the hash should be used
+    auto hashes = std::unordered_set<std::uint64_t>();
+    auto lowBits = std::unordered_set<std::uint64_t>();
+    auto longText = "x"_s * 200;
+
+    for (auto i = 0; i < 20000; ++i)
+    {
+        auto key = StringView (longText.toRawUTF8(), i % 200).hash() ^ String (i).hash();
+        hashes.insert (String (i).hash());
+        hashes.insert (StringView (longText.toRawUTF8(), i % 200).hash() + (std::uint64_t) i * 0x100000000ull);
+        lowBits.insert (key & 0xffff);
+    }
+
+    ASSERT_EQ (hashes.size(), (std::size_t) 40000);
+    ASSERT_GT (lowBits.size(), (std::size_t) 10000);
+}
+
+
+TEST_F (HashMapTest, MatchesStandardUnorderedMap)
+{
+    auto random = 777u;
+    auto nextRandom = [&random] { random = random * 1103515245u + 12345u; return (int) ((random >> 16) & 0x7fff); };
+
+    auto map = HashMap<String, int>();
+    auto expected = std::unordered_map<std::string, int>();
+
+    for (auto round = 0; round < 50000; ++round)
+    {
+        String key = String ("key") + nextRandom() % 3000;
+        auto value = nextRandom();
+
+        switch (nextRandom() % 4)
+        {
+            case 0:
+            case 1:
+                ASSERT_EQ (map.set (key, value), expected.count (key.toStdString()) == 0);
+                expected[key.toStdString()] = value;
+                break;
+            case 2:
+                ASSERT_EQ (map.remove (key.view()), expected.erase (key.toStdString()) == 1);
+                break;
+            default:
+            {
+                auto* found = map.find (key.toRawUTF8());
+                auto iterator = expected.find (key.toStdString());
+                ASSERT_EQ (found != nullptr, iterator != expected.end());
+
+                if (found != nullptr)
+                {
+                    ASSERT_EQ (*found, iterator->second);
+                }
+            }
+        }
+
+        ASSERT_EQ (map.getNumItems(), (int) expected.size());
+    }
+
+    auto numVisited = 0;
+
+    for (auto& entry : map)
+    {
+        ASSERT_EQ (entry.value, expected[entry.key.toStdString()]);
+        ++numVisited;
+    }
+
+    ASSERT_EQ (numVisited, (int) expected.size());
+
+    auto copy = map;
+    map.clear();
+    ASSERT_TRUE (map.isEmpty());
+    ASSERT_EQ (copy.getNumItems(), (int) expected.size());
+    ASSERT_FALSE (map.contains ("key1"));
+}
+
+
+TEST_F (HashMapTest, HeterogeneousLookupAndSets)
+{
+    auto symbols = HashMap<String, int>();
+    symbols["main"] = 1;
+    symbols[StringView ("exit")] += 2;
+    symbols["exit"_s] += 3;
+
+    auto line = "call exit"_s;
+    ASSERT_EQ (*symbols.find (line.substringView (5, 4)), 5);
+    ASSERT_EQ (*symbols.find ("main"), 1);
+    ASSERT_EQ (symbols.find ("mai"), nullptr);
+    ASSERT_EQ (symbols.getNumItems(), 2);
+
+    auto counts = HashMap<int, int>();
+
+    for (auto i = 0; i < 1000; ++i)
+        counts[i % 10] += 1;
+
+    ASSERT_EQ (counts.getNumItems(), 10);
+    ASSERT_EQ (*counts.find (7), 100);
+
+    auto seen = HashSet<String>();
+    auto numUnique = 0;
+
+    for (auto word : tokenize ("the cat and the dog and the bird", " "))
+        if (seen.add (word))
+            ++numUnique;
+
+    ASSERT_EQ (numUnique, 5);
+    ASSERT_TRUE (seen.contains ("bird"));
+    ASSERT_TRUE (seen.remove ("bird"_s));
+    ASSERT_FALSE (seen.contains (StringView ("bird")));
+
+    auto pool = StringPool();
+    auto interned = HashSet<InternedString>();
+    interned.add (pool.intern ("cpu"));
+    interned.add (pool.intern ("cpu"_s));
+    ASSERT_EQ (interned.getNumItems(), 1);
+    ASSERT_TRUE (interned.contains (pool.intern ("cpu")));
+    ASSERT_TRUE (interned.contains ("cpu"));
+
+    auto shared = HashMap<SharedString, int>();
+    shared.set (SharedString ("route"_s), 200);
+    ASSERT_EQ (*shared.find ("route"), 200);
+}
+
+// ===============================================================================================
+
+class FileTest   : public testing::Test
+{
+public:
+    FileTest() = default;
+    void SetUp() override {}
+    void TearDown() override {}
+
+    static std::string writeTemporaryFile (const char* name, const std::string& contents)
+    {
+        auto path = testing::TempDir() + name;
+        auto* file = std::fopen (path.c_str(), "wb");
+        std::fwrite (contents.data(), 1, contents.size(), file);
+        std::fclose (file);
+        return path;
+    }
+};
+
+
+TEST_F (FileTest, MappedFilesAndLoading)
+{
+    auto contents = std::string();
+
+    for (auto i = 0; i < 10000; ++i)
+        contents += "line " + std::to_string (i) + "\n";
+
+    auto path = writeTemporaryFile ("hosa_mapped.txt", contents);
+
+    auto file = MappedFile (path.c_str(), MappedFile::AccessPattern::sequential);
+    ASSERT_TRUE (file.isOpen());
+    ASSERT_EQ (file.getSize(), (std::int64_t) contents.size());
+    ASSERT_EQ (file.view(), StringView (contents.data(), (int) contents.size()));
+    ASSERT_EQ (file.view (5, 3), "0\nl");
+    ASSERT_EQ (file.view (file.getSize() - 2, 100), "9\n");
+    ASSERT_TRUE (file.view (file.getSize(), 10).isEmpty());
+    file.advise (MappedFile::AccessPattern::random);
+    file.prefetch (4000, 20000);
+
+    auto moved = std::move (file);
+    ASSERT_FALSE (file.isOpen());
+    ASSERT_EQ (moved.view().substring (0, 7), "line 0\n");
+
+    auto loaded = String::loadFromFile (path.c_str());
+    ASSERT_EQ (loaded.length(), (int) contents.size());
+    ASSERT_EQ (loaded.view(), moved.view());
+
+    ASSERT_FALSE (MappedFile ("/non/existing/file").isOpen());
+    ASSERT_EQ (String::loadFromFile ("/non/existing/file").length(), 0);
+
+    auto emptyFile = MappedFile (writeTemporaryFile ("hosa_empty.txt", {}).c_str());
+    ASSERT_TRUE (emptyFile.isOpen());
+    ASSERT_TRUE (emptyFile.view().isEmpty());
+}
+
+
+TEST_F (FileTest, LineReaderCrossesBufferBoundaries)
+{
+    auto expected = std::vector<std::string>();
+    auto contents = std::string();
+
+    for (auto i = 0; i < 2000; ++i)
+    {
+        // a mix of empty, short and (for the small buffer) very long lines, some ending in \r\n
+        auto line = std::string ((std::size_t) ((i * 7919) % (i % 50 == 0 ? 300 : 40)), (char) ('a' + i % 26));
+        expected.push_back (line);
+        contents += line + (i % 3 == 0 ? "\r\n" : "\n");
+    }
+
+    expected.push_back ("no line ending");
+    contents += "no line ending";
+    auto path = writeTemporaryFile ("hosa_lines.txt", contents);
+
+    for (auto bufferSize : { 16, 100, LineReader::defaultBufferSize })
+    {
+        auto reader = LineReader (path.c_str(), bufferSize);
+        auto line = StringView();
+        auto index = (std::size_t) 0;
+
+        while (reader.readNextLine (line))
+        {
+            ASSERT_LT (index, expected.size());
+            ASSERT_EQ (line, StringView (expected[index].data(), (int) expected[index].size()));
+            ++index;
+        }
+
+        ASSERT_EQ (index, expected.size());
+        ASSERT_EQ (reader.getNumLinesRead(), (std::int64_t) expected.size());
+        ASSERT_FALSE (reader.hadReadError());
+        ASSERT_LE (reader.getBufferSize(), bufferSize < 400 ? 400 : bufferSize);
+    }
+
+    auto reader = LineReader (writeTemporaryFile ("hosa_crlf.txt", "a\r\n\r\nb\n").c_str());
+    auto line = StringView();
+    ASSERT_TRUE (reader.readNextLine (line) && line == "a");
+    ASSERT_TRUE (reader.readNextLine (line) && line.isEmpty());
+    ASSERT_TRUE (reader.readNextLine (line) && line == "b");
+    ASSERT_FALSE (reader.readNextLine (line));
+
+    auto missing = LineReader ("/non/existing/file");
+    ASSERT_FALSE (missing.readNextLine (line));
+    ASSERT_TRUE (missing.hadReadError());
+}
+
+TEST_F (FileTest, WriterBuffersAndFormats)
+{
+    auto path = testing::TempDir() + "hosa_writer.txt";
+    auto* file = std::fopen (path.c_str(), "wb");
+    auto expected = std::string();
+
+    {
+        auto writer = Writer (fileno (file), 64);
+
+        writer.printLine ("text ", "string"_s, ' ', StringView ("view"), ' ', std::string ("std"));
+        expected += "text string view std\n";
+
+        writer.printLine (0, ' ', -42, ' ', 18446744073709551615ull, ' ', std::numeric_limits<long long>::min(), ' ', true);
+        expected += "0 -42 18446744073709551615 -9223372036854775808 1\n";
+
+        // Strings are copied as they are: streaming would stop at the embedded null
+        static_assert (details::HasRawUTF8AndLength<String>::value);
+        writer.printLine (String (StringView ("a\0b", 3)));
+        expected += std::string ("a\0b\n", 4);
+
+        writer.printLine (1.5, ' ', 0.1f, ' ', 1e100, ' ', 3.0);
+        expected += "1.5 0.1 1e+100 3\n";
+
+        // bigger than the buffer, so it's written together with what's buffered
+        auto big = std::string (1000, 'x');
+        writer.print ("before ").printLine (big);
+        expected += "before " + big + "\n";
+
+        for (auto i = 0; i < 500; ++i)
+        {
+            writer.printLine ("line ", i);
+            expected += "line " + std::to_string (i) + "\n";
+            ASSERT_LE (writer.getNumBufferedBytes(), 64);
+        }
+
+        ASSERT_TRUE (writer.flush());
+        ASSERT_EQ (writer.getNumBufferedBytes(), 0);
+        writer.print ("unflushed");
+        expected += "unflushed";
+    }
+
+    std::fclose (file);
+    ASSERT_EQ (String::loadFromFile (path.c_str()).toStdString(), expected);
+}
+
+TEST_F (FileTest, AsyncLoggerWritesAllLines)
+{
+    auto path = testing::TempDir() + "hosa_log.txt";
+    auto* file = std::fopen (path.c_str(), "wb");
+    constexpr auto numThreads = 4, numLinesPerThread = 5000;
+
+    {
+        auto logger = AsyncLogger (fileno (file), AsyncLogger::OverflowPolicy::block, 1024);
+        logger.setMinimumLevel (AsyncLogger::Level::info);
+
+        ASSERT_TRUE (logger.debug ("skipped {}", 1));
+        ASSERT_TRUE (logger.warning ("{} {} {} {} {}", "text", "string"_s, StringView ("view"), 'c', 2.5));
+        ASSERT_FALSE (logger.error ("{}", std::string (2000, 'x')));
+        ASSERT_EQ (logger.getNumDropped(), 1u);
+        logger.flush();
+
+        auto firstLine = String::loadFromFile (path.c_str());
+        ASSERT_EQ (firstLine.length(), 27 + 8 + 22 + 1);
+        ASSERT_EQ (firstLine.substring (27, firstLine.length() - 27), "WARNING text string view c 2.5\n");
+        ASSERT_EQ (firstLine[4], '-');
+        ASSERT_EQ (firstLine[19], '.');
+
+        auto threads = std::vector<std::thread>();
+
+        for (auto t = 0; t < numThreads; ++t)
+            threads.emplace_back ([&logger, t]
+            {
+                for (auto i = 0; i < numLinesPerThread; ++i)
+                    logger.info ("thread {} line {}", t, i);
+            });
+
+        for (auto& thread : threads)
+            thread.join();
+    }
+
+    std::fclose (file);
+    auto lines = String::loadFromFile (path.c_str()).split ("\n");
+    ASSERT_EQ (lines.getNumItems(), 1 + numThreads * numLinesPerThread + 1);
+
+    // lines of each thread come out in the order they were logged in
+    int nextLine[numThreads] {};
+
+    for (auto i = 1; i < lines.getNumItems() - 1; ++i)
+    {
+        auto message = lines[i].substring (27 + 8, lines[i].length() - 27 - 8);
+        auto t = message[7] - '0';
+        ASSERT_EQ (message, String ("thread {} line {}").formatted (t, nextLine[t]));
+        ++nextLine[t];
+    }
+}
+
+TEST_F (FileTest, AsyncLoggerFitsBigLinesAfterTheRingWrapped)
+{
+    auto path = testing::TempDir() + "hosa_big_lines.txt";
+    auto* file = std::fopen (path.c_str(), "wb");
+    auto expected = std::vector<std::string>();
+
+    for (auto policy : { AsyncLogger::OverflowPolicy::block, AsyncLogger::OverflowPolicy::drop })
+    {
+        auto logger = AsyncLogger (fileno (file), policy, 1024);
+
+        // the second line fits neither before the end of the ring nor in front of the first one,
+        // so the end has to be skipped before the reader has made room at the start
+        ASSERT_TRUE (logger.info ("{}", std::string (400, 'a')));
+        logger.flush();
+        ASSERT_TRUE (logger.info ("{}", std::string (600, 'b')));
+        logger.flush();
+        ASSERT_TRUE (logger.info ("{}", std::string (600, 'c')));
+        logger.flush();
+        ASSERT_EQ (logger.getNumDropped(), 0u);
+
+        expected.insert (expected.end(), { std::string (400, 'a'), std::string (600, 'b'), std::string (600, 'c') });
+    }
+
+    std::fclose (file);
+    auto lines = String::loadFromFile (path.c_str()).split ("\n");
+    ASSERT_EQ (lines.getNumItems(), (int) expected.size() + 1);
+
+    for (auto i = 0; i < (int) expected.size(); ++i)
+        ASSERT_EQ (lines[i].substring (27 + 8, lines[i].length() - 27 - 8), expected[(std::size_t) i].c_str());
+}
+
 // ===============================================================================================
 
 int main()
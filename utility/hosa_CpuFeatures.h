@@ -0,0 +1,87 @@
+/*
+    Copyright (C)2020 Wouter Ensink
+
+    This file is part of the Hosa [Header Only String & Array] C++ Project
+        - see the github page to find out more: www.github.com/w-ensink/hosa
+
+    The code in this file is provided under the terms of the ISC license:
+    Permission to use, copy, modify, and/or distribute this software for any purpose with
+    or without fee is hereby granted, provided that the above copyright notice and this
+    permission notice appear in all copies.
+
+    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO
+    THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT
+    SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR
+    ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF
+    CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE
+    OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+
+#pragma once
+
+// SSE2 is part of every x86-64 cpu, so it can be used without checking anything at runtime
+#if defined (__SSE2__) || defined (_M_X64)
+    #define HOSA_SSE2 1
+    #include <emmintrin.h>
+#endif
+
+// AVX2 isn't, so those code paths get compiled with a target attribute and are only called
+// after asking the cpu whether it supports them
+#if (defined (__GNUC__) || defined (__clang__)) && (defined (__x86_64__) || defined (__i386__))
+    #define HOSA_AVX2_DISPATCH 1
+    #define HOSA_TARGET_AVX2 __attribute__ ((target ("avx2")))
+    #include <immintrin.h>
+#endif
+
+
+namespace hosa::details
+{
+
+struct CpuFeatures final
+{
+    static bool hasAVX2() noexcept
+    {
+       #if HOSA_AVX2_DISPATCH
+        static const bool supported = __builtin_cpu_supports ("avx2");
+        return supported;
+       #else
+        return false;
+       #endif
+    }
+
+
+    static int countTrailingZeros (unsigned int mask) noexcept
+    {
+       #if defined (__GNUC__) || defined (__clang__)
+        return __builtin_ctz (mask);
+       #else
+        auto num = 0;
+
+        while ((mask & 1u) == 0)
+        {
+            mask >>= 1;
+            ++num;
+        }
+
+        return num;
+       #endif
+    }
+
+
+    static int countSetBits (unsigned int mask) noexcept
+    {
+       #if defined (__GNUC__) || defined (__clang__)
+        return __builtin_popcount (mask);
+       #else
+        auto num = 0;
+
+        for (; mask != 0; mask &= mask - 1)
+            ++num;
+
+        return num;
+       #endif
+    }
+};
+
+} // namespace hosa::details
@@ -22,10 +22,17 @@
 
 #include <cstddef>
 #include <cstdlib>
+#include <cstring>
+#include <new>
+#include <utility>
+#include "hosa_MemoryResource.h"
 
 namespace hosa::details
 {
 
+/** A block of heap memory, or of memory from a MemoryResource when it's given one.
+    The resource stays with the memory: moving or swapping blocks moves their resources along.
+ */
 template <typename ContainedType>
 class DynamicMemoryBlock final
 {
@@ -33,22 +40,29 @@ public:
     
     DynamicMemoryBlock() = default;
     
-    DynamicMemoryBlock (std::size_t numElements, bool zeroInit = false)
+    explicit DynamicMemoryBlock (MemoryResource* memoryResource) noexcept
+        : resource (memoryResource)
+    {
+    }
+    
+    DynamicMemoryBlock (std::size_t numElements, bool zeroInit = false, MemoryResource* memoryResource = nullptr)
+        : resource (memoryResource)
     {
         allocate (numElements, zeroInit);
     }
     
     DynamicMemoryBlock (DynamicMemoryBlock&& other) noexcept
-        : data (other.data)
+        : data (other.data), resource (other.resource), numBytes (other.numBytes)
     {
         other.data = nullptr;
+        other.numBytes = 0;
     }
     
     ~DynamicMemoryBlock() { free(); }
     
     DynamicMemoryBlock& operator= (DynamicMemoryBlock&& other) noexcept
     {
-        std::swap (data, other.data);
+        swapWith (other);
         return *this;
     }
   
@@ -74,41 +88,75 @@ public:
     
     
     
+    /** The resource the memory comes from, or nullptr for the heap. */
+    MemoryResource* getMemoryResource() const noexcept { return resource; }
+    
+    /** Changes where the memory comes from, which frees the current memory. */
+    void setMemoryResource (MemoryResource* newResource) noexcept
+    {
+        free();
+        resource = newResource;
+    }
+    
+    
+    
     void allocateForElementSize (std::size_t numElements, std::size_t elementSize)
     {
         free();
-        data = static_cast<ContainedType*> (std::malloc (numElements * elementSize));
+        data = static_cast<ContainedType*> (allocateBytes (numElements * elementSize));
     }
     
     void allocateZeroInit (std::size_t numItems, const std::size_t elementSize = sizeof (ContainedType))
     {
         free();
-        data = static_cast<ContainedType*> (std::calloc (numItems, elementSize));
+
+        if (resource == nullptr)
+        {
+            data = static_cast<ContainedType*> (std::calloc (numItems, elementSize));
+            return;
+        }
+
+        data = static_cast<ContainedType*> (allocateBytes (numItems * elementSize));
+        memset (static_cast<void*> (data), 0, numBytes);
     }
     
     void allocate (std::size_t newNumElements, bool zeroInit = false)
     {
-        free();
-        data = static_cast<ContainedType*> (zeroInit
-                                             ? std::calloc (newNumElements, sizeof (ContainedType))
-                                             : std::malloc (newNumElements * sizeof (ContainedType)));
+        if (zeroInit)
+            allocateZeroInit (newNumElements);
+        else
+            allocateForElementSize (newNumElements, sizeof (ContainedType));
     }
    
     void reallocate (std::size_t numElements, std::size_t elementSize = sizeof (ContainedType))
     {
-        data = static_cast<ContainedType*> (data == nullptr ? std::malloc (numElements * elementSize)
-                                                            : std::realloc (data, numElements * elementSize));
+        auto newNumBytes = numElements * elementSize;
+
+        if (resource == nullptr)
+            data = static_cast<ContainedType*> (data == nullptr ? std::malloc (newNumBytes)
+                                                                : std::realloc (data, newNumBytes));
+        else
+            data = static_cast<ContainedType*> (resource->reallocate (data, numBytes, newNumBytes, alignof (ContainedType)));
+
+        numBytes = newNumBytes;
     }
     
     void free() noexcept
     {
-        delete[] data;
+        if (resource == nullptr)
+            std::free (data);
+        else if (data != nullptr)
+            resource->deallocate (data, numBytes, alignof (ContainedType));
+
         data = nullptr;
+        numBytes = 0;
     }
 
     void swapWith (DynamicMemoryBlock& other) noexcept
     {
         std::swap (data, other.data);
+        std::swap (resource, other.resource);
+        std::swap (numBytes, other.numBytes);
     }
     
     void clear (std::size_t numElements) noexcept
@@ -118,7 +166,15 @@ public:
     
 private:
     
+    void* allocateBytes (std::size_t newNumBytes)
+    {
+        numBytes = newNumBytes;
+        return resource == nullptr ? std::malloc (newNumBytes) : resource->allocate (newNumBytes, alignof (ContainedType));
+    }
+    
     ContainedType* data = nullptr;
+    MemoryResource* resource = nullptr;
+    std::size_t numBytes = 0;
 };
 
 } // namespace hosa::details
@@ -0,0 +1,178 @@
+/*
+    Copyright (C)2020 Wouter Ensink
+
+    This file is part of the Hosa [Header Only String & Array] C++ Project
+        - see the github page to find out more: www.github.com/w-ensink/hosa
+
+    The code in this file is provided under the terms of the ISC license:
+    Permission to use, copy, modify, and/or distribute this software for any purpose with
+    or without fee is hereby granted, provided that the above copyright notice and this
+    permission notice appear in all copies.
+
+    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO
+    THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT
+    SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR
+    ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF
+    CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE
+    OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined (_MSC_VER) && defined (_M_X64)
+    #include <intrin.h>
+#endif
+
+namespace hosa::details
+{
+
+/** Hashing of raw bytes, following wyhash (final version 4): it reads 8 or 16 bytes per step,
+    mixes them with 64x64 -> 128 bit multiplications, and passes SMHasher.
+ */
+struct Hashing final
+{
+    static constexpr std::uint64_t defaultSeed = 0;
+
+    static std::uint64_t hashBytes (const void* data, std::size_t length, std::uint64_t seed = defaultSeed) noexcept
+    {
+        auto* p = static_cast<const unsigned char*> (data);
+        seed ^= mix (seed ^ secret[0], secret[1]);
+        std::uint64_t a, b;
+
+        if (length <= 16)
+        {
+            if (length >= 4)
+            {
+                auto middle = (length >> 3) << 2;
+                a = (read4 (p) << 32) | read4 (p + middle);
+                b = (read4 (p + length - 4) << 32) | read4 (p + length - 4 - middle);
+            }
+            else if (length > 0)
+            {
+                a = read1To3 (p, length);
+                b = 0;
+            }
+            else
+            {
+                a = b = 0;
+            }
+        }
+        else
+        {
+            auto remaining = length;
+
+            if (remaining > 48)
+            {
+                auto seed1 = seed, seed2 = seed;
+
+                do
+                {
+                    seed  = mix (read8 (p)      ^ secret[1], read8 (p + 8)  ^ seed);
+                    seed1 = mix (read8 (p + 16) ^ secret[2], read8 (p + 24) ^ seed1);
+                    seed2 = mix (read8 (p + 32) ^ secret[3], read8 (p + 40) ^ seed2);
+                    p += 48;
+                    remaining -= 48;
+                }
+                while (remaining > 48);
+
+                seed ^= seed1 ^ seed2;
+            }
+
+            while (remaining > 16)
+            {
+                seed = mix (read8 (p) ^ secret[1], read8 (p + 8) ^ seed);
+                p += 16;
+                remaining -= 16;
+            }
+
+            a = read8 (p + remaining - 16);
+            b = read8 (p + remaining - 8);
+        }
+
+        a ^= secret[1];
+        b ^= seed;
+        multiply (a, b);
+        return mix (a ^ secret[0] ^ length, b ^ secret[1]);
+    }
+
+    /** Spreads the bits of a (possibly weak) hash, like the identity std::hash of integers, over all 64 bits. */
+    static std::uint64_t mixBits (std::uint64_t value) noexcept
+    {
+        return mix (value ^ secret[0], secret[1]);
+    }
+
+private:
+
+    static constexpr std::uint64_t secret[4] { 0x2d358dccaa6c78a5ull, 0x8bb84b93962eacc9ull,
+                                               0x4b33a62ed433d4a3ull, 0x4d5a2da51de1aa47ull };
+
+    // replaces a and b by the low and high halves of their 128 bit product
+    static void multiply (std::uint64_t& a, std::uint64_t& b) noexcept
+    {
+       #if defined (__SIZEOF_INT128__)
+        __extension__ using UInt128 = unsigned __int128;
+        auto product = static_cast<UInt128> (a) * b;
+        a = static_cast<std::uint64_t> (product);
+        b = static_cast<std::uint64_t> (product >> 64);
+       #elif defined (_MSC_VER) && defined (_M_X64)
+        a = _umul128 (a, b, &b);
+       #else
+        const std::uint64_t aHigh = a >> 32, aLow = a & 0xffffffffu, bHigh = b >> 32, bLow = b & 0xffffffffu;
+        const std::uint64_t high = aHigh * bHigh, middle1 = aHigh * bLow, middle2 = aLow * bHigh, low = aLow * bLow;
+        auto carry = ((low >> 32) + (middle1 & 0xffffffffull) + (middle2 & 0xffffffffull)) >> 32;
+        a = low + (middle1 << 32) + (middle2 << 32);
+        b = high + (middle1 >> 32) + (middle2 >> 32) + carry;
+       #endif
+    }
+
+    static std::uint64_t mix (std::uint64_t a, std::uint64_t b) noexcept
+    {
+        multiply (a, b);
+        return a ^ b;
+    }
+
+    // the reads are little endian, so hashes are the same on every platform
+    static std::uint64_t read8 (const unsigned char* p) noexcept
+    {
+        std::uint64_t value;
+        memcpy (&value, p, 8);
+        return isLittleEndian() ? value : byteSwap (value);
+    }
+
+    static std::uint64_t read4 (const unsigned char* p) noexcept
+    {
+        std::uint32_t value;
+        memcpy (&value, p, 4);
+        return isLittleEndian() ? value : byteSwap (value) >> 32;
+    }
+
+    static std::uint64_t read1To3 (const unsigned char* p, std::size_t length) noexcept
+    {
+        return (((std::uint64_t) p[0]) << 16) | (((std::uint64_t) p[length >> 1]) << 8) | p[length - 1];
+    }
+
+    static bool isLittleEndian() noexcept
+    {
+        const std::uint16_t one = 1;
+        unsigned char firstByte;
+        memcpy (&firstByte, &one, 1);
+        return firstByte == 1;
+    }
+
+    static std::uint64_t byteSwap (std::uint64_t value) noexcept
+    {
+        auto result = (std::uint64_t) 0;
+
+        for (auto i = 0; i < 8; ++i, value >>= 8)
+            result = (result << 8) | (value & 0xffu);
+
+        return result;
+    }
+};
+
+} // namespace hosa::details
@@ -0,0 +1,387 @@
+/*
+    Copyright (C)2020 Wouter Ensink
+
+    This file is part of the Hosa [Header Only String & Array] C++ Project
+        - see the github page to find out more: www.github.com/w-ensink/hosa
+
+    The code in this file is provided under the terms of the ISC license:
+    Permission to use, copy, modify, and/or distribute this software for any purpose with
+    or without fee is hereby granted, provided that the above copyright notice and this
+    permission notice appear in all copies.
+
+    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO
+    THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT
+    SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR
+    ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF
+    CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE
+    OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+namespace hosa
+{
+
+/** Where Arrays, Strings and DynamicMemoryBlocks get their memory from, when they're given one.
+    Without one, they use the heap like they always did.
+ */
+class MemoryResource
+{
+public:
+
+    virtual ~MemoryResource() = default;
+
+    virtual void* allocate (std::size_t numBytes, std::size_t alignment) = 0;
+
+    /** Gives back memory that was allocated by this resource, with the same size and alignment. */
+    virtual void deallocate (void* data, std::size_t numBytes, std::size_t alignment) noexcept = 0;
+
+    /** Resizes an allocation, keeping its contents (up to the smaller of both sizes).
+        Resources that can grow allocations in place can do so by overriding this.
+     */
+    virtual void* reallocate (void* data, std::size_t oldNumBytes, std::size_t newNumBytes, std::size_t alignment)
+    {
+        auto* newData = allocate (newNumBytes, alignment);
+
+        if (data != nullptr)
+        {
+            memcpy (newData, data, oldNumBytes < newNumBytes ? oldNumBytes : newNumBytes);
+            deallocate (data, oldNumBytes, alignment);
+        }
+
+        return newData;
+    }
+};
+
+//==============================================================================
+
+/** The heap, through malloc and free. */
+class HeapMemoryResource final : public MemoryResource
+{
+public:
+
+    void* allocate (std::size_t numBytes, std::size_t) override
+    {
+        auto* data = std::malloc (numBytes == 0 ? 1 : numBytes);
+
+        if (data == nullptr)
+            throw std::bad_alloc();
+
+        return data;
+    }
+
+    void deallocate (void* data, std::size_t, std::size_t) noexcept override
+    {
+        std::free (data);
+    }
+
+    void* reallocate (void* data, std::size_t, std::size_t newNumBytes, std::size_t) override
+    {
+        auto* newData = std::realloc (data, newNumBytes == 0 ? 1 : newNumBytes);
+
+        if (newData == nullptr)
+            throw std::bad_alloc();
+
+        return newData;
+    }
+};
+
+
+/** The resource that is used by whatever isn't given one. */
+inline MemoryResource& getDefaultMemoryResource() noexcept
+{
+    static HeapMemoryResource heap;
+    return heap;
+}
+
+//==============================================================================
+
+/** Hands out memory by bumping a pointer through big chunks, and frees it all at once with reset().
+
+    Meant for memory that all dies at the same time, like everything made while handling a request:
+    allocating is nearly free, and deallocating does nothing (apart from taking back the most recent
+    allocation, so a growing Array or String at the end of the arena can be resized in place).
+    Not thread safe, use one arena per thread.
+
+    @code
+    auto arena = MonotonicArena (64 * 1024);
+
+    for (auto& request : requests)
+    {
+        auto fields = Array<String> (arena);
+        ...
+        arena.reset();
+    }
+    @endcode
+ */
+class MonotonicArena final : public MemoryResource
+{
+public:
+
+    explicit MonotonicArena (std::size_t initialChunkSize = 4096, MemoryResource& upstreamResource = getDefaultMemoryResource())
+        : upstream (upstreamResource), nextChunkSize (initialChunkSize < 64 ? 64 : initialChunkSize)
+    {
+    }
+
+    ~MonotonicArena() override { release(); }
+
+    MonotonicArena (const MonotonicArena&) = delete;
+    MonotonicArena& operator= (const MonotonicArena&) = delete;
+
+    void* allocate (std::size_t numBytes, std::size_t alignment) override
+    {
+        auto start = alignUp (position, alignment);
+
+        if (chunk == nullptr || start + numBytes > chunkEnd())
+        {
+            addChunk (numBytes + alignment);
+            start = alignUp (position, alignment);
+        }
+
+        lastAllocation = start;
+        position = start + numBytes;
+        numBytesAllocated += numBytes;
+        return reinterpret_cast<void*> (start);
+    }
+
+    void deallocate (void* data, std::size_t numBytes, std::size_t) noexcept override
+    {
+        if (isLastAllocation (data, numBytes))
+        {
+            position = lastAllocation;
+            numBytesAllocated -= numBytes;
+        }
+    }
+
+    void* reallocate (void* data, std::size_t oldNumBytes, std::size_t newNumBytes, std::size_t alignment) override
+    {
+        if (isLastAllocation (data, oldNumBytes) && lastAllocation + newNumBytes <= chunkEnd())
+        {
+            position = lastAllocation + newNumBytes;
+            numBytesAllocated = numBytesAllocated - oldNumBytes + newNumBytes;
+            return data;
+        }
+
+        return MemoryResource::reallocate (data, oldNumBytes, newNumBytes, alignment);
+    }
+
+    /** Makes all memory available again at once. Everything that was allocated from the arena
+        must be gone (or at least never used again) by then. The biggest chunk is kept for reuse.
+     */
+    void reset() noexcept
+    {
+        if (chunk == nullptr)
+            return;
+
+        // an oversized allocation can make an older chunk bigger than the latest one
+        auto* biggest = chunk;
+
+        for (auto* c = chunk->previous; c != nullptr; c = c->previous)
+            if (c->size > biggest->size)
+                biggest = c;
+
+        for (auto* c = chunk; c != nullptr;)
+        {
+            auto* previous = c->previous;
+
+            if (c != biggest)
+                upstream.deallocate (c, c->size, alignof (std::max_align_t));
+
+            c = previous;
+        }
+
+        chunk = biggest;
+        chunk->previous = nullptr;
+        position = firstByteOf (chunk);
+        lastAllocation = 0;
+        numBytesAllocated = 0;
+    }
+
+    /** Gives all chunks back to the upstream resource. */
+    void release() noexcept
+    {
+        freeChunks (chunk);
+        chunk = nullptr;
+        position = lastAllocation = 0;
+        numBytesAllocated = 0;
+    }
+
+    /** The number of bytes handed out since the last reset. */
+    [[nodiscard]] std::size_t getNumBytesAllocated() const noexcept { return numBytesAllocated; }
+
+private:
+
+    // every chunk starts with this header, the memory that is handed out follows it
+    struct Chunk
+    {
+        Chunk* previous;
+        std::size_t size;
+    };
+
+    static std::uintptr_t alignUp (std::uintptr_t address, std::size_t alignment) noexcept
+    {
+        return (address + alignment - 1) & ~(std::uintptr_t) (alignment - 1);
+    }
+
+    static std::uintptr_t firstByteOf (Chunk* c) noexcept { return reinterpret_cast<std::uintptr_t> (c + 1); }
+
+    std::uintptr_t chunkEnd() const noexcept { return reinterpret_cast<std::uintptr_t> (chunk) + chunk->size; }
+
+    bool isLastAllocation (void* data, std::size_t numBytes) const noexcept
+    {
+        return data != nullptr && reinterpret_cast<std::uintptr_t> (data) == lastAllocation
+                && lastAllocation + numBytes == position;
+    }
+
+    void addChunk (std::size_t minNumBytes)
+    {
+        auto size = sizeof (Chunk) + (minNumBytes > nextChunkSize ? minNumBytes : nextChunkSize);
+        auto* newChunk = static_cast<Chunk*> (upstream.allocate (size, alignof (std::max_align_t)));
+        newChunk->previous = chunk;
+        newChunk->size = size;
+
+        chunk = newChunk;
+        position = firstByteOf (chunk);
+        nextChunkSize *= 2;
+    }
+
+    void freeChunks (Chunk* c) noexcept
+    {
+        while (c != nullptr)
+        {
+            auto* previous = c->previous;
+            upstream.deallocate (c, c->size, alignof (std::max_align_t));
+            c = previous;
+        }
+    }
+
+
+    MemoryResource& upstream;
+    Chunk* chunk = nullptr;
+    std::size_t nextChunkSize;
+    std::uintptr_t position = 0;
+    std::uintptr_t lastAllocation = 0;
+    std::size_t numBytesAllocated = 0;
+};
+
+//==============================================================================
+
+/** Keeps freed memory in lists per size class (powers of two from 16 up to 4096 bytes), so it can
+    be handed out again without going to the heap. Bigger allocations go straight to the upstream
+    resource. Good for many small, short lived allocations of mixed sizes. Not thread safe.
+ */
+class PoolMemoryResource final : public MemoryResource
+{
+public:
+
+    explicit PoolMemoryResource (MemoryResource& upstreamResource = getDefaultMemoryResource())
+        : upstream (upstreamResource)
+    {
+    }
+
+    ~PoolMemoryResource() override { release(); }
+
+    PoolMemoryResource (const PoolMemoryResource&) = delete;
+    PoolMemoryResource& operator= (const PoolMemoryResource&) = delete;
+
+    void* allocate (std::size_t numBytes, std::size_t alignment) override
+    {
+        if (numBytes > maxPooledSize || alignment > minPooledSize)
+            return upstream.allocate (numBytes, alignment);
+
+        auto sizeClass = sizeClassOf (numBytes);
+
+        if (auto* block = freeLists[sizeClass])
+        {
+            freeLists[sizeClass] = block->next;
+            return block;
+        }
+
+        auto blockSize = minPooledSize << sizeClass;
+
+        if (slabPosition + blockSize > slabEnd)
+            addSlab();
+
+        auto* block = slabPosition;
+        slabPosition += blockSize;
+        return block;
+    }
+
+    void deallocate (void* data, std::size_t numBytes, std::size_t alignment) noexcept override
+    {
+        if (numBytes > maxPooledSize || alignment > minPooledSize)
+        {
+            upstream.deallocate (data, numBytes, alignment);
+            return;
+        }
+
+        auto sizeClass = sizeClassOf (numBytes);
+        auto* block = static_cast<FreeBlock*> (data);
+        block->next = freeLists[sizeClass];
+        freeLists[sizeClass] = block;
+    }
+
+    /** Gives all memory back to the upstream resource, including what's still in use. */
+    void release() noexcept
+    {
+        while (slabs != nullptr)
+        {
+            auto* previous = slabs->next;
+            upstream.deallocate (slabs, slabSize, alignof (std::max_align_t));
+            slabs = previous;
+        }
+
+        for (auto& list : freeLists)
+            list = nullptr;
+
+        slabPosition = slabEnd = nullptr;
+    }
+
+private:
+
+    struct FreeBlock
+    {
+        FreeBlock* next;
+    };
+
+    static constexpr std::size_t minPooledSize = 16;
+    static constexpr std::size_t maxPooledSize = 4096;
+    static constexpr int numSizeClasses = 9;
+    static constexpr std::size_t slabSize = 64 * 1024;
+
+    static int sizeClassOf (std::size_t numBytes) noexcept
+    {
+        auto sizeClass = 0;
+
+        while ((minPooledSize << sizeClass) < numBytes)
+            ++sizeClass;
+
+        return sizeClass;
+    }
+
+    // slabs are carved up into blocks from front to back, their first 16 bytes link them together
+    void addSlab()
+    {
+        auto* slab = static_cast<FreeBlock*> (upstream.allocate (slabSize, alignof (std::max_align_t)));
+        slab->next = slabs;
+        slabs = slab;
+        slabPosition = reinterpret_cast<char*> (slab) + minPooledSize;
+        slabEnd = reinterpret_cast<char*> (slab) + slabSize;
+    }
+
+
+    MemoryResource& upstream;
+    FreeBlock* freeLists[numSizeClasses] {};
+    FreeBlock* slabs = nullptr;
+    char* slabPosition = nullptr;
+    char* slabEnd = nullptr;
+};
+
+} // namespace hosa
@@ -23,6 +23,12 @@
 #include <type_traits>
 #include <iostream>
 
+// define this to make print() (and the print() of Strings) go through a buffered Writer instead of
+// std::cout, the output is then written when the thread's Writer is flushed or the thread ends
+#ifdef HOSA_BUFFERED_PRINT
+    #include "hosa_Writer.h"
+#endif
+
 namespace hosa
 {
 
@@ -48,6 +54,14 @@ using NotMoveAssignableVoid = typename std::enable_if<! IsMoveAssignable<T>::val
 template <typename T>
 using CopyAssignableType = typename std::enable_if<std::is_copy_assignable<T>::value, T>::type;
 
+
+// chars are treated as text, all other integral types (bool included) as numbers
+template <typename T>
+using IsIntegerNumber = std::integral_constant<bool, std::is_integral<T>::value && ! std::is_same<T, char>::value>;
+
+template <typename T, typename ReturnType = void>
+using IntegerNumberType = typename std::enable_if<IsIntegerNumber<T>::value, ReturnType>::type;
+
 template <typename NumericType = int>
 constexpr auto isPositiveAndBelow (NumericType numToCheck, NumericType limit) noexcept
 {
@@ -80,9 +94,15 @@ constexpr auto isIOStreamableType()
 template <typename... IOStreamableType>
 auto print (IOStreamableType&&... arguments)
 {
+   #ifdef HOSA_BUFFERED_PRINT
+    auto& writer = Writer::forThisThread();
+    (writer.print (arguments, ' '), ...);
+    writer.writeChar ('\n');
+   #else
     ([] (auto&& argument) { std::cout << argument << " "; } (arguments), ...);
     
     std::cout << '\n';
+   #endif
 }
 
 template<typename T, typename... T2>
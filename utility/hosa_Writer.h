@@ -0,0 +1,309 @@
+/*
+    Copyright (C)2020 Wouter Ensink
+
+    This file is part of the Hosa [Header Only String & Array] C++ Project
+        - see the github page to find out more: www.github.com/w-ensink/hosa
+
+    The code in this file is provided under the terms of the ISC license:
+    Permission to use, copy, modify, and/or distribute this software for any purpose with
+    or without fee is hereby granted, provided that the above copyright notice and this
+    permission notice appear in all copies.
+
+    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO
+    THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT
+    SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR
+    ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF
+    CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE
+    OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+
+#pragma once
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include "hosa_DynamicMemoryBlock.h"
+#include "../string/hosa_NumberFormatting.h"
+
+#if defined (_WIN32)
+    #include <io.h>
+#else
+    #include <sys/uio.h>
+    #include <unistd.h>
+#endif
+
+namespace hosa
+{
+
+namespace details
+{
+
+template <typename T, typename = void>
+struct HasDataAndLength : std::false_type {};
+
+// StringView, SharedString, InternedString and std::string all look like this
+template <typename T>
+struct HasDataAndLength<T, std::void_t<decltype (std::declval<const T&>().data()),
+                                       decltype (std::declval<const T&>().length())>>
+    : std::is_convertible<decltype (std::declval<const T&>().data()), const char*> {};
+
+template <typename T, typename = void>
+struct HasRawUTF8AndLength : std::false_type {};
+
+// and String looks like this (it can't be named here, as it includes this file)
+template <typename T>
+struct HasRawUTF8AndLength<T, std::void_t<decltype (std::declval<const T&>().toRawUTF8()),
+                                          decltype (std::declval<const T&>().length())>>
+    : std::is_convertible<decltype (std::declval<const T&>().toRawUTF8()), const char*> {};
+
+} // namespace details
+
+
+/** Writes text to a file descriptor (stdout by default) through a big buffer, so that printing
+    many small pieces costs a memcpy each instead of a system call or a synchronised iostream call.
+
+    The buffer is written out with write() when it's full, when flush() is called, and when the
+    Writer is destroyed. Texts that don't fit in the buffer are written together with it in a single
+    writev(), without being copied. Strings, numbers and chars are formatted without iostreams,
+    anything else that can be streamed goes through a std::ostringstream.
+
+    Don't mix a Writer with other ways of writing to the same file descriptor (like std::cout)
+    without flushing it first, or the output will come out of order.
+
+    @code
+    auto& out = Writer::forThisThread();
+
+    for (auto& row : rows)
+        out.printLine (row.name, ": ", row.value);
+
+    out.flush();
+    @endcode
+ */
+class Writer final
+{
+public:
+
+    static constexpr int standardOutput = 1;
+    static constexpr int defaultBufferSize = 64 * 1024;
+
+    explicit Writer (int fileDescriptorToWriteTo = standardOutput, int bufferSize = defaultBufferSize)
+        : fileDescriptor (fileDescriptorToWriteTo),
+          capacity (bufferSize < 64 ? 64 : bufferSize),
+          buffer ((std::size_t) capacity)
+    {
+    }
+
+    ~Writer() { flush(); }
+
+    Writer (const Writer&) = delete;
+    Writer& operator= (const Writer&) = delete;
+
+    /** A Writer to stdout for the calling thread, which is flushed when the thread ends. */
+    static Writer& forThisThread()
+    {
+        thread_local Writer writer;
+        return writer;
+    }
+
+    //==============================================================================
+
+    /** Writes all arguments directly after each other. */
+    template <typename... Arguments>
+    Writer& print (const Arguments&... arguments)
+    {
+        (printOne (arguments), ...);
+        return *this;
+    }
+
+    /** Writes all arguments directly after each other, followed by a new line. */
+    template <typename... Arguments>
+    Writer& printLine (const Arguments&... arguments)
+    {
+        (printOne (arguments), ...);
+        return writeChar ('\n');
+    }
+
+    Writer& write (const char* data, std::size_t numBytes)
+    {
+        if (numBytes <= (std::size_t) (capacity - numUsed))
+        {
+            memcpy (buffer.getData() + numUsed, data, numBytes);
+            numUsed += (int) numBytes;
+        }
+        else if (numBytes < (std::size_t) capacity / 2)
+        {
+            flush();
+            memcpy (buffer.getData(), data, numBytes);
+            numUsed = (int) numBytes;
+        }
+        else
+        {
+            writeTogetherWithBuffer (data, numBytes);
+        }
+
+        return *this;
+    }
+
+    Writer& writeChar (char c)
+    {
+        if (numUsed == capacity)
+            flush();
+
+        buffer[(std::size_t) numUsed++] = c;
+        return *this;
+    }
+
+    /** Writes out everything that was buffered, returns false if that failed. */
+    bool flush()
+    {
+        auto succeeded = writeAll (buffer.getData(), (std::size_t) numUsed);
+        numUsed = 0;
+        return succeeded;
+    }
+
+    /** The number of bytes that are waiting in the buffer. */
+    [[nodiscard]] int getNumBufferedBytes() const noexcept { return numUsed; }
+
+    /** True if any write to the file descriptor failed so far. */
+    [[nodiscard]] bool hadWriteError() const noexcept { return writeError; }
+
+private:
+
+    template <typename T>
+    void printOne (const T& value)
+    {
+        if constexpr (std::is_same<T, char>::value)
+            writeChar (value);
+        else if constexpr (std::is_same<T, bool>::value)
+            writeChar (value ? '1' : '0');
+        else if constexpr (std::is_integral<T>::value)
+            writeInteger (value);
+        else if constexpr (std::is_floating_point<T>::value)
+            writeFloatingPoint (value);
+        else if constexpr (std::is_convertible<const T&, const char*>::value)
+            writeCString (value);
+        else if constexpr (details::HasDataAndLength<T>::value)
+            write (value.data(), (std::size_t) value.length());
+        else if constexpr (details::HasRawUTF8AndLength<T>::value)
+            write (value.toRawUTF8(), (std::size_t) value.length());
+        else
+            writeStreamed (value);
+    }
+
+    void writeCString (const char* text)
+    {
+        if (text != nullptr)
+            write (text, strlen (text));
+    }
+
+    template <typename IntegerType>
+    void writeInteger (IntegerType value)
+    {
+        char digits[details::NumberFormatting::maxCharsForIntegerType<IntegerType>];
+        write (digits, (std::size_t) details::NumberFormatting::writeInteger (digits, value));
+    }
+
+    // the same notation std::cout uses by default
+    template <typename FloatType>
+    void writeFloatingPoint (FloatType value)
+    {
+        char text[64];
+        auto length = std::is_same<FloatType, long double>::value
+                        ? std::snprintf (text, sizeof (text), "%Lg", (long double) value)
+                        : std::snprintf (text, sizeof (text), "%g", (double) value);
+
+        if (length > 0)
+            write (text, (std::size_t) length);
+    }
+
+    template <typename T>
+    void writeStreamed (const T& value)
+    {
+        auto stream = std::ostringstream();
+        stream << value;
+        auto text = stream.str();
+        write (text.data(), text.size());
+    }
+
+    void writeTogetherWithBuffer (const char* data, std::size_t numBytes)
+    {
+       #if defined (_WIN32)
+        flush();
+        writeAll (data, numBytes);
+       #else
+        iovec parts[2] { { buffer.getData(), (std::size_t) numUsed }, { const_cast<char*> (data), numBytes } };
+        auto* part = parts;
+        auto numParts = 2;
+        numUsed = 0;
+
+        while (numParts > 0)
+        {
+            auto numWritten = ::writev (fileDescriptor, part, numParts);
+
+            if (numWritten < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+
+                writeError = true;
+                return;
+            }
+
+            // skips what was written, which may have ended halfway a part
+            while (numParts > 0 && (std::size_t) numWritten >= part->iov_len)
+            {
+                numWritten -= (ssize_t) part->iov_len;
+                ++part;
+                --numParts;
+            }
+
+            if (numParts > 0)
+            {
+                part->iov_base = static_cast<char*> (part->iov_base) + numWritten;
+                part->iov_len -= (std::size_t) numWritten;
+            }
+        }
+       #endif
+    }
+
+    bool writeAll (const char* data, std::size_t numBytes)
+    {
+        while (numBytes > 0)
+        {
+           #if defined (_WIN32)
+            auto numWritten = (long long) ::_write (fileDescriptor, data, (unsigned int) numBytes);
+           #else
+            auto numWritten = (long long) ::write (fileDescriptor, data, numBytes);
+           #endif
+
+            if (numWritten < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+
+                writeError = true;
+                return false;
+            }
+
+            data += numWritten;
+            numBytes -= (std::size_t) numWritten;
+        }
+
+        return true;
+    }
+
+
+    int fileDescriptor;
+    int capacity;
+    details::DynamicMemoryBlock<char> buffer;
+    int numUsed = 0;
+    bool writeError = false;
+};
+
+} // namespace hosa